@@ -0,0 +1,45 @@
+/* config.h.  Generated from config.h.in by configure.  */
+//
+// Configuration file for Mini-XML, a small XML file parsing library.
+//
+// https://www.msweet.org/mxml
+//
+// Copyright © 2003-2026 by Michael R Sweet.
+//
+// Licensed under Apache License v2.0.  See the file "LICENSE" for more
+// information.
+//
+
+#ifndef MXML_CONFIG_H
+#  define MXML_CONFIG_H
+
+
+//
+// Version number
+//
+
+#  define MXML_VERSION "Mini-XML v4.0.5"
+
+
+//
+// Have <pthread.h>?
+//
+
+#  define HAVE_PTHREAD_H 1
+
+
+//
+// Have <sys/mman.h>?
+//
+
+#  define HAVE_SYS_MMAN_H 1
+
+
+//
+// Have <zlib.h>?
+//
+
+#  define HAVE_ZLIB_H 1
+
+
+#endif // !MXML_CONFIG_H
@@ -39,4 +39,11 @@
 #  define HAVE_PTHREAD_H 1
 
 
+//
+// Have <sys/mman.h>?
+//
+
+#  define HAVE_SYS_MMAN_H 1
+
+
 #endif // !MXML_CONFIG_H
@@ -16,9 +16,52 @@
 // Local functions...
 //
 
+static bool	mxml_add_attr(mxml_node_t *node, const char *name, char *value);
 static bool	mxml_set_attr(mxml_node_t *node, const char *name, char *value);
 
 
+//
+// 'mxmlAttrsNext()' - Get the next attribute for the event callback.
+//
+// This function gets the name and value of the next attribute of an element
+// reported to the event callback set with @link mxmlOptionsSetEventCallback@.
+// The `namelen` and `valuelen` arguments can be `NULL` if the lengths are not
+// needed.  `false` is returned when there are no more attributes.
+//
+
+bool					// O - `true` if there is an attribute, `false` otherwise
+mxmlAttrsNext(mxml_attrs_t *attrs,	// I - Attributes
+              const char   **name,	// O - Attribute name
+              size_t       *namelen,	// O - Length of name or `NULL`
+              const char   **value,	// O - Attribute value
+              size_t       *valuelen)	// O - Length of value or `NULL`
+{
+  size_t	nlen,			// Length of name
+		vlen;			// Length of value
+
+
+  // Range check input...
+  if (!attrs || !name || !value || attrs->ptr >= attrs->end)
+    return (false);
+
+  // Return the next name and value...
+  nlen = strlen(attrs->ptr);
+  vlen = strlen(attrs->ptr + nlen + 1);
+
+  *name  = attrs->ptr;
+  *value = attrs->ptr + nlen + 1;
+
+  if (namelen)
+    *namelen = nlen;
+  if (valuelen)
+    *valuelen = vlen;
+
+  attrs->ptr += nlen + vlen + 2;
+
+  return (true);
+}
+
+
 //
 // 'mxmlElementClearAttr()' - Remove an attribute from an element.
 //
@@ -224,32 +267,53 @@ mxmlElementSetAttrf(mxml_node_t *node,	// I - Element node
 
 
 //
-// 'mxml_set_attr()' - Set or add an attribute name/value pair.
+// '_mxml_add_attr()' - Add a new attribute to an element.
+//
+// This function adds attribute `name` with a copy of the string `value` to the
+// element `node` without looking for an existing attribute with the same name.
+// The caller must ensure that the name is not already used.
 //
 
-static bool				// O - `true` on success, `false` on failure
-mxml_set_attr(mxml_node_t *node,	// I - Element node
-              const char  *name,	// I - Attribute name
-              char        *value)	// I - Attribute value
+bool					// O - `true` on success, `false` on failure
+_mxml_add_attr(mxml_node_t *node,	// I - Element node
+               const char  *name,	// I - Attribute name
+               const char  *value)	// I - Attribute value
 {
-  size_t	i;			// Looping var
-  _mxml_attr_t	*attr;			// New attribute
+  char	*valuec;			// Copy of value
 
 
-  // Look for the attribute...
-  for (i = node->value.element.num_attrs, attr = node->value.element.attrs; i > 0; i --, attr ++)
+  if (value)
   {
-    if (!strcmp(attr->name, name))
-    {
-      // Free the old value as needed...
-      _mxml_strfree(attr->value);
-      attr->value = value;
+    if ((valuec = _mxml_strcopy(value)) == NULL)
+      return (false);
+  }
+  else
+  {
+    valuec = NULL;
+  }
 
-      return (true);
-    }
+  if (!mxml_add_attr(node, name, valuec))
+  {
+    _mxml_strfree(valuec);
+    return (false);
   }
 
-  // Add a new attribute...
+  return (true);
+}
+
+
+//
+// 'mxml_add_attr()' - Add an attribute name/value pair.
+//
+
+static bool				// O - `true` on success, `false` on failure
+mxml_add_attr(mxml_node_t *node,	// I - Element node
+              const char  *name,	// I - Attribute name
+              char        *value)	// I - Attribute value
+{
+  _mxml_attr_t	*attr;			// New attribute
+
+
   if ((node->value.element.num_attrs % MXML_ALLOC_SIZE) == 0)
   {
     if ((attr = realloc(node->value.element.attrs, (node->value.element.num_attrs + MXML_ALLOC_SIZE) * sizeof(_mxml_attr_t))) == NULL)
@@ -269,3 +333,34 @@ mxml_set_attr(mxml_node_t *node,	// I - Element node
 
   return (true);
 }
+
+
+//
+// 'mxml_set_attr()' - Set or add an attribute name/value pair.
+//
+
+static bool				// O - `true` on success, `false` on failure
+mxml_set_attr(mxml_node_t *node,	// I - Element node
+              const char  *name,	// I - Attribute name
+              char        *value)	// I - Attribute value
+{
+  size_t	i;			// Looping var
+  _mxml_attr_t	*attr;			// Current attribute
+
+
+  // Look for the attribute...
+  for (i = node->value.element.num_attrs, attr = node->value.element.attrs; i > 0; i --, attr ++)
+  {
+    if (!strcmp(attr->name, name))
+    {
+      // Free the old value as needed...
+      _mxml_strfree(attr->value);
+      attr->value = value;
+
+      return (true);
+    }
+  }
+
+  // Add a new attribute...
+  return (mxml_add_attr(node, name, value));
+}
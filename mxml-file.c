@@ -10,12 +10,42 @@
 //
 
 #include "mxml-private.h"
+#include <float.h>
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif // __SSE2__
+#ifdef HAVE_SYS_MMAN_H
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif // HAVE_SYS_MMAN_H
+#ifdef HAVE_PTHREAD_H
+#  include <pthread.h>
+#  if !_WIN32
+#    include <poll.h>
+#    include <sys/stat.h>
+#  endif // !_WIN32
+#endif // HAVE_PTHREAD_H
+#ifdef HAVE_ZLIB_H
+#  include <zlib.h>
+#endif // HAVE_ZLIB_H
 
 
 //
 // Local types...
 //
 
+typedef enum _mxml_char_e		// Character classes
+{
+  _MXML_CHAR_SPACE = 0x01,		// Whitespace
+  _MXML_CHAR_TEXT = 0x02,		// Plain text character (not '<', '&', or newline)
+  _MXML_CHAR_TAG = 0x04,		// Plain element name character
+  _MXML_CHAR_NAME = 0x08,		// Plain attribute name character
+  _MXML_CHAR_VALUE = 0x10,		// Plain unquoted attribute value character
+  _MXML_CHAR_NAME_END = 0x20,		// Ends an unquoted attribute name
+  _MXML_CHAR_VALUE_END = 0x40		// Ends an unquoted attribute value
+} _mxml_char_t;
+
 typedef enum _mxml_encoding_e		// Character encoding
 {
   _MXML_ENCODING_UTF8,			// UTF-8
@@ -23,6 +53,211 @@ typedef enum _mxml_encoding_e		// Character encoding
   _MXML_ENCODING_UTF16LE		// UTF-16 Little-Endian
 } _mxml_encoding_t;
 
+#ifdef HAVE_ZLIB_H
+typedef struct _mxml_inflate_s		// Decompression state
+{
+  z_stream		stream;		// Decompression stream
+  bool			stream_end,	// Reached end of compressed stream?
+			done;		// No more decompressed data?
+  const unsigned char	*ptr,		// Pointer into compressed data in memory
+			*end;		// End of compressed data in memory
+  unsigned char		buffer[MXML_READ_SIZE];
+					// Compressed data buffer
+} _mxml_inflate_t;
+#endif // HAVE_ZLIB_H
+
+typedef struct _mxml_read_s		// Read buffer
+{
+  mxml_io_cb_t		io_cb;		// Read callback function or `NULL` for memory
+  void			*io_cbdata;	// Read callback data
+#ifdef HAVE_ZLIB_H
+  _mxml_inflate_t	*inflate;	// Decompression state, if any
+#endif // HAVE_ZLIB_H
+#ifdef HAVE_PTHREAD_H
+  struct _mxml_readahead_s *readahead;	// Read-ahead thread data, if any
+#endif // HAVE_PTHREAD_H
+  const char		*error;		// Read error message, if any
+  size_t		erroffset;	// Byte offset of read error
+  _mxml_encoding_t	encoding;	// Character encoding
+  bool			partial,	// More data may be pushed?
+			starved;	// Ran out of pushed data?
+  unsigned char		*buffer,	// Buffer
+			*bufptr,	// Pointer into buffer
+			*bufend;	// End of data in buffer
+  size_t		bufsize,	// Size of buffer
+			offset;		// Bytes of data before the buffer
+  unsigned char		*curptr,	// Pointer into validated UTF-8
+			*curend,	// End of validated UTF-8
+			*utf8,		// UTF-8 buffer for UTF-16 input
+			*tellptr,	// Last position in UTF-8 buffer
+			*tellraw;	// Buffer position for tellptr
+} _mxml_read_t;
+
+typedef enum _mxml_lstate_e		// Load state
+{
+  _MXML_LSTATE_START,			// Read first character
+  _MXML_LSTATE_CHAR,			// Read next character
+  _MXML_LSTATE_TAG,			// Read tag after '<'
+  _MXML_LSTATE_ENTITY,			// Read entity after '&'
+  _MXML_LSTATE_COMMENT,			// Read comment after '<!--'
+  _MXML_LSTATE_CDATA,			// Read CDATA after '<![CDATA['
+  _MXML_LSTATE_DIRECTIVE,		// Read processing instruction after '<?'
+  _MXML_LSTATE_DECLARATION,		// Read declaration after '<!'
+  _MXML_LSTATE_SKIP,			// Skip element contents
+  _MXML_LSTATE_DONE,			// Finished reading
+  _MXML_LSTATE_ERROR			// Stopped on an error
+} _mxml_lstate_t;
+
+typedef enum _mxml_filter_e		// Filter path match for an element
+{
+  _MXML_FILTER_NONE,			// Element cannot contain a match
+  _MXML_FILTER_ANCESTOR,		// Element may contain a match
+  _MXML_FILTER_MATCH			// Element matches
+} _mxml_filter_t;
+
+typedef struct _mxml_lazy_s		// Source data for elements that are loaded later
+{
+  size_t		refs;		// Number of references
+  mxml_options_t	options;	// Load options
+  void			*map;		// Mapped file data or `NULL`
+  size_t		maplen;		// Length of mapped file data
+} _mxml_lazy_t;
+
+typedef struct _mxml_lazyrange_s	// Source range for the contents of an element
+{
+  _mxml_lazy_t		*lazy;		// Source data
+  const unsigned char	*start,		// Start of contents
+			*end;		// End of close tag
+  int			line;		// Line number at start of contents
+} _mxml_lazyrange_t;
+
+typedef struct _mxml_load_s		// Load data
+{
+  _mxml_lstate_t	state;		// Current state
+  mxml_node_t		*top,		// Top node
+			*first,		// First node added
+			*parent;	// Current parent node
+  mxml_type_t		type;		// Current node type
+  int			line;		// Current line number
+  bool			whitespace,	// Whitespace seen?
+			stream;		// Stop after each document?
+  char			*buffer;	// String buffer
+  size_t		buflen,		// Length of string in buffer
+			bufsize;	// Size of buffer
+  unsigned char		*pos;		// Start of current tag or entity, or `NULL`
+  _mxml_encoding_t	encoding;	// Character encoding at pos
+  bool			share_names;	// Share element names?
+  size_t		num_names,	// Number of element names
+			alloc_names;	// Allocated element name slots (power of 2)
+  _mxml_name_t		**names;	// Element name hash table
+  _mxml_lazy_t		*lazy;		// Source data for loading element contents later or `NULL`
+  mxml_node_t		*match;		// Element matching a filter path, if any
+  const char		**path;		// Element names for matching filter paths
+  size_t		alloc_path;	// Allocated element names
+  size_t		skip_depth;	// Depth of skipped element contents
+  bool			skip_close;	// Report the close of the skipped element?
+  char			*stack;		// Open element names for the event callback
+  size_t		stacklen,	// Length of open element names
+			stacksize;	// Size of open element names
+  bool			root,		// Reported the root element to the event callback?
+			paused,		// Stop after the current event?
+			check_attrs;	// Check attributes for duplicates with the event callback?
+} _mxml_load_t;
+
+struct _mxml_parser_s			// Push parser
+{
+  mxml_options_t	*options;	// Load options
+  _mxml_read_t		r;		// Read buffer
+  _mxml_load_t		l;		// Load data
+  unsigned char		*data;		// Buffer for unread data
+  size_t		datasize;	// Size of data buffer
+};
+
+struct _mxml_reader_s			// Pull parser
+{
+  mxml_options_t	options;	// Load options with the event callback
+  _mxml_read_t		r;		// Read buffer
+  _mxml_load_t		l;		// Load data
+  int			fd;		// File descriptor, if any
+  size_t		num_events,	// Number of events from the last read
+			cur_event;	// Current event
+  mxml_sax_event_t	events[2];	// Events (an empty element is opened and closed together)
+  const char		*data[2];	// Data for events
+  size_t		datalen[2];	// Length of data for events
+  mxml_attrs_t		attrs,		// Attributes of the open element
+			cur_attrs;	// Attributes returned to the caller
+};
+
+struct _mxml_stream_s			// Document stream
+{
+  mxml_options_t	*options;	// Load options
+  _mxml_read_t		r;		// Read buffer
+  _mxml_load_t		l;		// Load data
+  int			fd;		// File descriptor, if any
+};
+
+typedef struct _mxml_attrhash_s		// Attribute name hash table
+{
+  size_t		size;		// Number of slots (power of 2)
+  size_t		*slots;		// Attribute index + 1 or `0` if empty
+} _mxml_attrhash_t;
+
+typedef struct _mxml_batch_s		// Batch of files to load
+{
+  const char * const	*filenames;	// Files to load
+  size_t		count,		// Number of files
+			next;		// Next file to load
+  mxml_options_t	*options;	// Load options
+  mxml_node_t		**results;	// Loaded nodes
+  mxml_strcopy_cb_t	strcopy_cb;	// String copy callback function
+  mxml_strfree_cb_t	strfree_cb;	// String free callback function
+  void			*str_cbdata;	// String callback data
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_t	mutex;		// Mutex for next file
+#endif // HAVE_PTHREAD_H
+} _mxml_batch_t;
+
+#ifdef HAVE_PTHREAD_H
+typedef struct _mxml_chunk_s		// Part of a document to load
+{
+  const unsigned char	*start,		// Start of chunk
+			*end;		// End of chunk
+  mxml_options_t	options;	// Load options with error callback for the chunk
+  mxml_node_t		*container;	// Copy of the root element for loaded nodes
+  int			lines;		// Number of lines in chunk
+  bool			error,		// Was an error reported?
+			loaded;		// Were complete nodes loaded?
+} _mxml_chunk_t;
+
+typedef struct _mxml_chunks_s		// Chunks of a document to load
+{
+  _mxml_chunk_t		*chunks;	// Chunks
+  size_t		count,		// Number of chunks
+			next;		// Next chunk to load
+  mxml_strcopy_cb_t	strcopy_cb;	// String copy callback function
+  mxml_strfree_cb_t	strfree_cb;	// String free callback function
+  void			*str_cbdata;	// String callback data
+  pthread_mutex_t	mutex;		// Mutex for next chunk
+} _mxml_chunks_t;
+
+typedef struct _mxml_readahead_s	// Read-ahead thread data
+{
+  mxml_io_cb_t		io_cb;		// Read callback function
+  void			*io_cbdata;	// Read callback data
+  int			wake[2];	// Pipe to wake the thread from a file descriptor read, if any
+  pthread_t		thread;		// Read-ahead thread
+  pthread_mutex_t	mutex;		// Mutex for buffers
+  pthread_cond_t	cond;		// Condition for buffer changes
+  bool			full[2],	// Is the buffer full?
+			stop;		// Stop reading?
+  size_t		bytes[2],	// Number of bytes in buffer
+			current,	// Buffer being read by the parser
+			offset;		// Offset in current buffer
+  unsigned char		buffers[2][MXML_READ_SIZE];
+					// Buffers
+} _mxml_readahead_t;
+#endif // HAVE_PTHREAD_H
+
 typedef struct _mxml_stringbuf_s	// String buffer
 {
   char		*buffer,		// Buffer
@@ -31,6 +266,18 @@ typedef struct _mxml_stringbuf_s	// String buffer
   bool		bufalloc;		// Allocate buffer?
 } _mxml_stringbuf_t;
 
+typedef struct _mxml_validate_s		// Well-formedness check
+{
+  mxml_options_t	options;	// Load options with the validation callbacks
+  mxml_options_t	*user_options;	// Caller's options for reporting errors
+  _mxml_read_t		*r;		// Read buffer or `NULL` if not open
+  _mxml_load_t		*l;		// Load data or `NULL` if not started
+  int			fd;		// File descriptor, if any
+  bool			error;		// Was an error reported?
+  bool			text;		// Found text outside the root element?
+  size_t		offset;		// Byte offset of first error
+} _mxml_validate_t;
+
 
 //
 // Macro to test for a bad XML character...
@@ -39,23 +286,276 @@ typedef struct _mxml_stringbuf_s	// String buffer
 #define mxml_bad_char(ch) ((ch) < ' ' && (ch) != '\n' && (ch) != '\r' && (ch) != '\t')
 
 
+//
+// Character class table - bytes 0x80 to 0xFF are used for all non-ASCII
+// characters...
+//
+
+static const unsigned char mxml_char_classes[256] =
+{
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x63, 0x61, 0x00, 0x00, 0x63, 0x00, 0x00,	// 0x00
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// 0x10
+  0x63, 0x1e, 0x1a, 0x1a, 0x1a, 0x1a, 0x00, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1e, 0x1e, 0x62,	// 0x20
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x18, 0x66, 0x62, 0x36,	// 0x30
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e,	// 0x40
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e,	// 0x50
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e,	// 0x60
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e,	// 0x70
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e,	// 0x80
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e,	// 0x90
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e,	// 0xA0
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e,	// 0xB0
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e,	// 0xC0
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e,	// 0xD0
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e,	// 0xE0
+  0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e	// 0xF0
+};
+
+
+//
+// Powers of 5 as normalized 128-bit numbers (truncated for positive powers and
+// rounded up for negative powers) for converting decimal numbers - the table
+// only covers the exponents that are common in XML data, other exponents use
+// strtod...
+//
+
+#define MXML_POW5_MIN	-64		// Smallest power of 5
+#define MXML_POW5_MAX	64		// Largest power of 5
+
+static const uint64_t mxml_pow5[MXML_POW5_MAX - MXML_POW5_MIN + 1][2] =
+{
+    { UINT64_C(0xa87fea27a539e9a5), UINT64_C(0x3f2398d747b36224) },	// 5^-64
+    { UINT64_C(0xd29fe4b18e88640e), UINT64_C(0x8eec7f0d19a03aad) },	// 5^-63
+    { UINT64_C(0x83a3eeeef9153e89), UINT64_C(0x1953cf68300424ac) },	// 5^-62
+    { UINT64_C(0xa48ceaaab75a8e2b), UINT64_C(0x5fa8c3423c052dd7) },	// 5^-61
+    { UINT64_C(0xcdb02555653131b6), UINT64_C(0x3792f412cb06794d) },	// 5^-60
+    { UINT64_C(0x808e17555f3ebf11), UINT64_C(0xe2bbd88bbee40bd0) },	// 5^-59
+    { UINT64_C(0xa0b19d2ab70e6ed6), UINT64_C(0x5b6aceaeae9d0ec4) },	// 5^-58
+    { UINT64_C(0xc8de047564d20a8b), UINT64_C(0xf245825a5a445275) },	// 5^-57
+    { UINT64_C(0xfb158592be068d2e), UINT64_C(0xeed6e2f0f0d56712) },	// 5^-56
+    { UINT64_C(0x9ced737bb6c4183d), UINT64_C(0x55464dd69685606b) },	// 5^-55
+    { UINT64_C(0xc428d05aa4751e4c), UINT64_C(0xaa97e14c3c26b886) },	// 5^-54
+    { UINT64_C(0xf53304714d9265df), UINT64_C(0xd53dd99f4b3066a8) },	// 5^-53
+    { UINT64_C(0x993fe2c6d07b7fab), UINT64_C(0xe546a8038efe4029) },	// 5^-52
+    { UINT64_C(0xbf8fdb78849a5f96), UINT64_C(0xde98520472bdd033) },	// 5^-51
+    { UINT64_C(0xef73d256a5c0f77c), UINT64_C(0x963e66858f6d4440) },	// 5^-50
+    { UINT64_C(0x95a8637627989aad), UINT64_C(0xdde7001379a44aa8) },	// 5^-49
+    { UINT64_C(0xbb127c53b17ec159), UINT64_C(0x5560c018580d5d52) },	// 5^-48
+    { UINT64_C(0xe9d71b689dde71af), UINT64_C(0xaab8f01e6e10b4a6) },	// 5^-47
+    { UINT64_C(0x9226712162ab070d), UINT64_C(0xcab3961304ca70e8) },	// 5^-46
+    { UINT64_C(0xb6b00d69bb55c8d1), UINT64_C(0x3d607b97c5fd0d22) },	// 5^-45
+    { UINT64_C(0xe45c10c42a2b3b05), UINT64_C(0x8cb89a7db77c506a) },	// 5^-44
+    { UINT64_C(0x8eb98a7a9a5b04e3), UINT64_C(0x77f3608e92adb242) },	// 5^-43
+    { UINT64_C(0xb267ed1940f1c61c), UINT64_C(0x55f038b237591ed3) },	// 5^-42
+    { UINT64_C(0xdf01e85f912e37a3), UINT64_C(0x6b6c46dec52f6688) },	// 5^-41
+    { UINT64_C(0x8b61313bbabce2c6), UINT64_C(0x2323ac4b3b3da015) },	// 5^-40
+    { UINT64_C(0xae397d8aa96c1b77), UINT64_C(0xabec975e0a0d081a) },	// 5^-39
+    { UINT64_C(0xd9c7dced53c72255), UINT64_C(0x96e7bd358c904a21) },	// 5^-38
+    { UINT64_C(0x881cea14545c7575), UINT64_C(0x7e50d64177da2e54) },	// 5^-37
+    { UINT64_C(0xaa242499697392d2), UINT64_C(0xdde50bd1d5d0b9e9) },	// 5^-36
+    { UINT64_C(0xd4ad2dbfc3d07787), UINT64_C(0x955e4ec64b44e864) },	// 5^-35
+    { UINT64_C(0x84ec3c97da624ab4), UINT64_C(0xbd5af13bef0b113e) },	// 5^-34
+    { UINT64_C(0xa6274bbdd0fadd61), UINT64_C(0xecb1ad8aeacdd58e) },	// 5^-33
+    { UINT64_C(0xcfb11ead453994ba), UINT64_C(0x67de18eda5814af2) },	// 5^-32
+    { UINT64_C(0x81ceb32c4b43fcf4), UINT64_C(0x80eacf948770ced7) },	// 5^-31
+    { UINT64_C(0xa2425ff75e14fc31), UINT64_C(0xa1258379a94d028d) },	// 5^-30
+    { UINT64_C(0xcad2f7f5359a3b3e), UINT64_C(0x096ee45813a04330) },	// 5^-29
+    { UINT64_C(0xfd87b5f28300ca0d), UINT64_C(0x8bca9d6e188853fc) },	// 5^-28
+    { UINT64_C(0x9e74d1b791e07e48), UINT64_C(0x775ea264cf55347e) },	// 5^-27
+    { UINT64_C(0xc612062576589dda), UINT64_C(0x95364afe032a819e) },	// 5^-26
+    { UINT64_C(0xf79687aed3eec551), UINT64_C(0x3a83ddbd83f52205) },	// 5^-25
+    { UINT64_C(0x9abe14cd44753b52), UINT64_C(0xc4926a9672793543) },	// 5^-24
+    { UINT64_C(0xc16d9a0095928a27), UINT64_C(0x75b7053c0f178294) },	// 5^-23
+    { UINT64_C(0xf1c90080baf72cb1), UINT64_C(0x5324c68b12dd6339) },	// 5^-22
+    { UINT64_C(0x971da05074da7bee), UINT64_C(0xd3f6fc16ebca5e04) },	// 5^-21
+    { UINT64_C(0xbce5086492111aea), UINT64_C(0x88f4bb1ca6bcf585) },	// 5^-20
+    { UINT64_C(0xec1e4a7db69561a5), UINT64_C(0x2b31e9e3d06c32e6) },	// 5^-19
+    { UINT64_C(0x9392ee8e921d5d07), UINT64_C(0x3aff322e62439fd0) },	// 5^-18
+    { UINT64_C(0xb877aa3236a4b449), UINT64_C(0x09befeb9fad487c3) },	// 5^-17
+    { UINT64_C(0xe69594bec44de15b), UINT64_C(0x4c2ebe687989a9b4) },	// 5^-16
+    { UINT64_C(0x901d7cf73ab0acd9), UINT64_C(0x0f9d37014bf60a11) },	// 5^-15
+    { UINT64_C(0xb424dc35095cd80f), UINT64_C(0x538484c19ef38c95) },	// 5^-14
+    { UINT64_C(0xe12e13424bb40e13), UINT64_C(0x2865a5f206b06fba) },	// 5^-13
+    { UINT64_C(0x8cbccc096f5088cb), UINT64_C(0xf93f87b7442e45d4) },	// 5^-12
+    { UINT64_C(0xafebff0bcb24aafe), UINT64_C(0xf78f69a51539d749) },	// 5^-11
+    { UINT64_C(0xdbe6fecebdedd5be), UINT64_C(0xb573440e5a884d1c) },	// 5^-10
+    { UINT64_C(0x89705f4136b4a597), UINT64_C(0x31680a88f8953031) },	// 5^-9
+    { UINT64_C(0xabcc77118461cefc), UINT64_C(0xfdc20d2b36ba7c3e) },	// 5^-8
+    { UINT64_C(0xd6bf94d5e57a42bc), UINT64_C(0x3d32907604691b4d) },	// 5^-7
+    { UINT64_C(0x8637bd05af6c69b5), UINT64_C(0xa63f9a49c2c1b110) },	// 5^-6
+    { UINT64_C(0xa7c5ac471b478423), UINT64_C(0x0fcf80dc33721d54) },	// 5^-5
+    { UINT64_C(0xd1b71758e219652b), UINT64_C(0xd3c36113404ea4a9) },	// 5^-4
+    { UINT64_C(0x83126e978d4fdf3b), UINT64_C(0x645a1cac083126ea) },	// 5^-3
+    { UINT64_C(0xa3d70a3d70a3d70a), UINT64_C(0x3d70a3d70a3d70a4) },	// 5^-2
+    { UINT64_C(0xcccccccccccccccc), UINT64_C(0xcccccccccccccccd) },	// 5^-1
+    { UINT64_C(0x8000000000000000), UINT64_C(0x0000000000000000) },	// 5^0
+    { UINT64_C(0xa000000000000000), UINT64_C(0x0000000000000000) },	// 5^1
+    { UINT64_C(0xc800000000000000), UINT64_C(0x0000000000000000) },	// 5^2
+    { UINT64_C(0xfa00000000000000), UINT64_C(0x0000000000000000) },	// 5^3
+    { UINT64_C(0x9c40000000000000), UINT64_C(0x0000000000000000) },	// 5^4
+    { UINT64_C(0xc350000000000000), UINT64_C(0x0000000000000000) },	// 5^5
+    { UINT64_C(0xf424000000000000), UINT64_C(0x0000000000000000) },	// 5^6
+    { UINT64_C(0x9896800000000000), UINT64_C(0x0000000000000000) },	// 5^7
+    { UINT64_C(0xbebc200000000000), UINT64_C(0x0000000000000000) },	// 5^8
+    { UINT64_C(0xee6b280000000000), UINT64_C(0x0000000000000000) },	// 5^9
+    { UINT64_C(0x9502f90000000000), UINT64_C(0x0000000000000000) },	// 5^10
+    { UINT64_C(0xba43b74000000000), UINT64_C(0x0000000000000000) },	// 5^11
+    { UINT64_C(0xe8d4a51000000000), UINT64_C(0x0000000000000000) },	// 5^12
+    { UINT64_C(0x9184e72a00000000), UINT64_C(0x0000000000000000) },	// 5^13
+    { UINT64_C(0xb5e620f480000000), UINT64_C(0x0000000000000000) },	// 5^14
+    { UINT64_C(0xe35fa931a0000000), UINT64_C(0x0000000000000000) },	// 5^15
+    { UINT64_C(0x8e1bc9bf04000000), UINT64_C(0x0000000000000000) },	// 5^16
+    { UINT64_C(0xb1a2bc2ec5000000), UINT64_C(0x0000000000000000) },	// 5^17
+    { UINT64_C(0xde0b6b3a76400000), UINT64_C(0x0000000000000000) },	// 5^18
+    { UINT64_C(0x8ac7230489e80000), UINT64_C(0x0000000000000000) },	// 5^19
+    { UINT64_C(0xad78ebc5ac620000), UINT64_C(0x0000000000000000) },	// 5^20
+    { UINT64_C(0xd8d726b7177a8000), UINT64_C(0x0000000000000000) },	// 5^21
+    { UINT64_C(0x878678326eac9000), UINT64_C(0x0000000000000000) },	// 5^22
+    { UINT64_C(0xa968163f0a57b400), UINT64_C(0x0000000000000000) },	// 5^23
+    { UINT64_C(0xd3c21bcecceda100), UINT64_C(0x0000000000000000) },	// 5^24
+    { UINT64_C(0x84595161401484a0), UINT64_C(0x0000000000000000) },	// 5^25
+    { UINT64_C(0xa56fa5b99019a5c8), UINT64_C(0x0000000000000000) },	// 5^26
+    { UINT64_C(0xcecb8f27f4200f3a), UINT64_C(0x0000000000000000) },	// 5^27
+    { UINT64_C(0x813f3978f8940984), UINT64_C(0x4000000000000000) },	// 5^28
+    { UINT64_C(0xa18f07d736b90be5), UINT64_C(0x5000000000000000) },	// 5^29
+    { UINT64_C(0xc9f2c9cd04674ede), UINT64_C(0xa400000000000000) },	// 5^30
+    { UINT64_C(0xfc6f7c4045812296), UINT64_C(0x4d00000000000000) },	// 5^31
+    { UINT64_C(0x9dc5ada82b70b59d), UINT64_C(0xf020000000000000) },	// 5^32
+    { UINT64_C(0xc5371912364ce305), UINT64_C(0x6c28000000000000) },	// 5^33
+    { UINT64_C(0xf684df56c3e01bc6), UINT64_C(0xc732000000000000) },	// 5^34
+    { UINT64_C(0x9a130b963a6c115c), UINT64_C(0x3c7f400000000000) },	// 5^35
+    { UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x4b9f100000000000) },	// 5^36
+    { UINT64_C(0xf0bdc21abb48db20), UINT64_C(0x1e86d40000000000) },	// 5^37
+    { UINT64_C(0x96769950b50d88f4), UINT64_C(0x1314448000000000) },	// 5^38
+    { UINT64_C(0xbc143fa4e250eb31), UINT64_C(0x17d955a000000000) },	// 5^39
+    { UINT64_C(0xeb194f8e1ae525fd), UINT64_C(0x5dcfab0800000000) },	// 5^40
+    { UINT64_C(0x92efd1b8d0cf37be), UINT64_C(0x5aa1cae500000000) },	// 5^41
+    { UINT64_C(0xb7abc627050305ad), UINT64_C(0xf14a3d9e40000000) },	// 5^42
+    { UINT64_C(0xe596b7b0c643c719), UINT64_C(0x6d9ccd05d0000000) },	// 5^43
+    { UINT64_C(0x8f7e32ce7bea5c6f), UINT64_C(0xe4820023a2000000) },	// 5^44
+    { UINT64_C(0xb35dbf821ae4f38b), UINT64_C(0xdda2802c8a800000) },	// 5^45
+    { UINT64_C(0xe0352f62a19e306e), UINT64_C(0xd50b2037ad200000) },	// 5^46
+    { UINT64_C(0x8c213d9da502de45), UINT64_C(0x4526f422cc340000) },	// 5^47
+    { UINT64_C(0xaf298d050e4395d6), UINT64_C(0x9670b12b7f410000) },	// 5^48
+    { UINT64_C(0xdaf3f04651d47b4c), UINT64_C(0x3c0cdd765f114000) },	// 5^49
+    { UINT64_C(0x88d8762bf324cd0f), UINT64_C(0xa5880a69fb6ac800) },	// 5^50
+    { UINT64_C(0xab0e93b6efee0053), UINT64_C(0x8eea0d047a457a00) },	// 5^51
+    { UINT64_C(0xd5d238a4abe98068), UINT64_C(0x72a4904598d6d880) },	// 5^52
+    { UINT64_C(0x85a36366eb71f041), UINT64_C(0x47a6da2b7f864750) },	// 5^53
+    { UINT64_C(0xa70c3c40a64e6c51), UINT64_C(0x999090b65f67d924) },	// 5^54
+    { UINT64_C(0xd0cf4b50cfe20765), UINT64_C(0xfff4b4e3f741cf6d) },	// 5^55
+    { UINT64_C(0x82818f1281ed449f), UINT64_C(0xbff8f10e7a8921a4) },	// 5^56
+    { UINT64_C(0xa321f2d7226895c7), UINT64_C(0xaff72d52192b6a0d) },	// 5^57
+    { UINT64_C(0xcbea6f8ceb02bb39), UINT64_C(0x9bf4f8a69f764490) },	// 5^58
+    { UINT64_C(0xfee50b7025c36a08), UINT64_C(0x02f236d04753d5b4) },	// 5^59
+    { UINT64_C(0x9f4f2726179a2245), UINT64_C(0x01d762422c946590) },	// 5^60
+    { UINT64_C(0xc722f0ef9d80aad6), UINT64_C(0x424d3ad2b7b97ef5) },	// 5^61
+    { UINT64_C(0xf8ebad2b84e0d58b), UINT64_C(0xd2e0898765a7deb2) },	// 5^62
+    { UINT64_C(0x9b934c3b330c8577), UINT64_C(0x63cc55f49f88eb2f) },	// 5^63
+    { UINT64_C(0xc2781f49ffcfa6d5), UINT64_C(0x3cbf6b71c76b25fb) }	// 5^64
+};
+
+
 //
 // Local functions...
 //
 
 static bool		mxml_add_char(mxml_options_t *options, int ch, char **ptr, char **buffer, size_t *bufsize);
-static int		mxml_get_entity(mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, _mxml_encoding_t *encoding, mxml_node_t *parent, int *line);
-static int		mxml_getc(mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, _mxml_encoding_t *encoding);
+static bool		mxml_add_chars(mxml_options_t *options, const unsigned char *s, size_t len, char **ptr, char **buffer, size_t *bufsize);
+static bool		mxml_check_attrs(mxml_options_t *options, _mxml_read_t *r, const char *element, const char *attrs, const char *end, int line);
+#ifdef HAVE_PTHREAD_H
+static size_t		mxml_cpu_count(void);
+#endif // HAVE_PTHREAD_H
+static const unsigned char *mxml_find_close(const unsigned char *ptr, const unsigned char *end);
+#ifdef HAVE_PTHREAD_H
+static const unsigned char *mxml_find_split(const unsigned char *ptr, const unsigned char *end, const unsigned char *name, size_t namelen);
+#endif // HAVE_PTHREAD_H
+static const unsigned char *mxml_find_string(const unsigned char *ptr, const unsigned char *end, const char *s);
+static int		mxml_get_entity(mxml_options_t *options, _mxml_read_t *r, const char *parent, int *line);
+static int		mxml_getc(mxml_options_t *options, _mxml_read_t *r);
+static size_t		*mxml_hash_attr(_mxml_attrhash_t *hash, mxml_node_t *node, const char *name);
+static bool		mxml_hash_attrs(_mxml_attrhash_t *hash, mxml_node_t *node);
+static size_t		mxml_hash_string(const char *s);
+static inline int	mxml_char_class(int ch)
+			{
+			  return (ch < 0 ? 0 : mxml_char_classes[ch < 0x100 ? ch : 0x80]);
+			}
 static inline int	mxml_isspace(int ch)
 			{
-			  return (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n');
+			  return (mxml_char_class(ch) & _MXML_CHAR_SPACE);
 			}
-static mxml_node_t	*mxml_load_data(mxml_node_t *top, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata);
-static int		mxml_parse_element(mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, mxml_node_t *node, _mxml_encoding_t *encoding, int *line);
+static void		mxml_lazy_release(_mxml_lazy_t *lazy);
+static void		*mxml_load_batch(_mxml_batch_t *batch);
+#ifdef HAVE_PTHREAD_H
+static void		mxml_load_chunk(_mxml_chunk_t *chunk);
+static void		mxml_load_chunk_error(_mxml_chunk_t *chunk, const char *message);
+static void		*mxml_load_chunks(_mxml_chunks_t *chunks);
+#endif // HAVE_PTHREAD_H
+static bool		mxml_load_close(_mxml_load_t *l, const char *name);
+static mxml_node_t	*mxml_load_data(mxml_node_t *top, mxml_options_t *options, _mxml_read_t *r, _mxml_lazy_t *lazy);
+static void		mxml_load_error(mxml_options_t *options, _mxml_read_t *r, const char *format, ...) MXML_FORMAT(3,4);
+static _mxml_filter_t	mxml_load_filter(_mxml_load_t *l, mxml_options_t *options, mxml_node_t *parent, const char *name);
+static mxml_node_t	*mxml_load_finish(_mxml_load_t *l, mxml_options_t *options);
+static void		mxml_load_free(_mxml_load_t *l);
+static bool		mxml_load_init(_mxml_load_t *l, mxml_node_t *top, mxml_options_t *options);
+static mxml_node_t	*mxml_load_io(mxml_node_t *top, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata);
+static bool		mxml_load_keep(_mxml_load_t *l, mxml_options_t *options, mxml_node_t *parent);
+static mxml_node_t	*mxml_load_memory(mxml_node_t *top, mxml_options_t *options, const void *data, size_t datalen, bool mapped);
+static _mxml_name_t	*mxml_load_name(_mxml_load_t *l, const char *s);
+static bool		mxml_load_open(_mxml_load_t *l, mxml_options_t *options, const char *name, size_t namelen);
+static const char	*mxml_load_parent(_mxml_load_t *l, mxml_node_t *parent);
+#ifdef HAVE_PTHREAD_H
+static mxml_node_t	*mxml_load_parallel(mxml_node_t *top, mxml_options_t *options, const unsigned char *data, size_t datalen, const unsigned char *rootend);
+#endif // HAVE_PTHREAD_H
+static bool		mxml_load_parse(_mxml_load_t *l, mxml_options_t *options, _mxml_read_t *r);
+static void		mxml_load_reset(_mxml_load_t *l, mxml_node_t *top, mxml_options_t *options);
+static bool		mxml_load_skip(_mxml_load_t *l, _mxml_read_t *r, mxml_node_t *node, int *line);
+static mxml_type_t	mxml_load_type(mxml_options_t *options, mxml_node_t *node);
+static _mxml_filter_t	mxml_match_path(const char *path, const char * const *names, size_t count);
+static uint64_t		mxml_mul128(uint64_t a, uint64_t b, uint64_t *hi);
+static int		mxml_parse_attrs(mxml_options_t *options, _mxml_read_t *r, char **bufptr, char **buffer, size_t *bufsize, int *line);
+static int		mxml_parse_element(mxml_options_t *options, _mxml_read_t *r, mxml_node_t *node, int *line);
+static bool		mxml_parser_reserve(mxml_parser_t *parser, size_t bytes);
+#ifdef HAVE_PTHREAD_H
+static bool		mxml_read_ahead_ok(mxml_io_cb_t io_cb, void *io_cbdata);
+static _mxml_readahead_t *mxml_read_ahead_start(mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata);
+static size_t		mxml_read_ahead_stop(_mxml_readahead_t *ra);
+static void		*mxml_read_ahead_thread(_mxml_readahead_t *ra);
+#endif // HAVE_PTHREAD_H
+static bool		mxml_read_bytes(_mxml_read_t *r, unsigned char *buffer, size_t bytes);
+static bool		mxml_read_detect(mxml_options_t *options, _mxml_read_t *r);
+static void		mxml_read_free(_mxml_read_t *r);
+static bool		mxml_read_open(_mxml_read_t *r, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, const void *data, size_t datalen);
+#ifdef HAVE_ZLIB_H
+static size_t		mxml_read_inflate(_mxml_read_t *r);
+#endif // HAVE_ZLIB_H
+static size_t		mxml_read_quoted(_mxml_read_t *r, int quote, int *line);
+static bool		mxml_read_span(mxml_options_t *options, _mxml_read_t *r, int cls, char **bufptr, char **buffer, size_t *bufsize);
+static unsigned char	*mxml_read_tell(_mxml_read_t *r);
+static size_t		mxml_read_text(_mxml_read_t *r, bool spaces);
+static bool		mxml_read_transcode(_mxml_read_t *r);
+static size_t		mxml_read_until(_mxml_read_t *r, const char *term, int *line);
+static bool		mxml_read_validate(_mxml_read_t *r);
+#ifdef HAVE_PTHREAD_H
+static size_t		mxml_read_cb_ahead(_mxml_readahead_t *ra, void *buffer, size_t bytes);
+#endif // HAVE_PTHREAD_H
 static size_t		mxml_read_cb_fd(int *fd, void *buffer, size_t bytes);
 static size_t		mxml_read_cb_file(FILE *fp, void *buffer, size_t bytes);
-static size_t		mxml_read_cb_string(_mxml_stringbuf_t *sb, void *buffer, size_t bytes);
-static double		mxml_strtod(mxml_options_t *options, const char *buffer, char **bufptr);
+static bool		mxml_reader_cb(mxml_reader_t *reader, mxml_sax_event_t event, const char *data, size_t datalen, mxml_attrs_t *attrs);
+static mxml_reader_t	*mxml_reader_new(mxml_options_t *options, int fd, mxml_io_cb_t io_cb, void *io_cbdata, const void *data, size_t datalen);
+#ifdef HAVE_PTHREAD_H
+static const unsigned char *mxml_scan_root(const unsigned char *data, size_t datalen);
+#endif // HAVE_PTHREAD_H
+static int		mxml_skip_element(_mxml_load_t *l, mxml_options_t *options, _mxml_read_t *r, int ch, int *line);
+static int		mxml_skip_until(mxml_options_t *options, _mxml_read_t *r, const char *term, int *line);
+static mxml_stream_t	*mxml_stream_new(mxml_options_t *options, int fd, mxml_io_cb_t io_cb, void *io_cbdata, const void *data, size_t datalen);
+static double		mxml_strtod(const char *buffer, char **bufend);
+static bool		mxml_strtod_lemire(uint64_t mantissa, int exponent, bool negative, double *value);
+static long		mxml_strtol(const char *buffer, char **bufend);
+static bool		mxml_validate(mxml_options_t *options, int fd, mxml_io_cb_t io_cb, void *io_cbdata, const void *data, size_t datalen, int *errline, size_t *erroffset);
+static bool		mxml_validate_cb(_mxml_validate_t *v, mxml_sax_event_t event, const char *data, size_t datalen, mxml_attrs_t *attrs);
+static void		mxml_validate_error(_mxml_validate_t *v, const char *message);
+static bool		mxml_validate_space(const char *data, size_t datalen);
 static size_t		mxml_io_cb_fd(int *fd, void *buffer, size_t bytes);
 static size_t		mxml_io_cb_file(FILE *fp, void *buffer, size_t bytes);
 static size_t		mxml_io_cb_string(_mxml_stringbuf_t *sb, void *buffer, size_t bytes);
@@ -64,6 +564,37 @@ static int		mxml_write_string(const char *s, mxml_io_cb_t io_cb, void *io_cbdata
 static int		mxml_write_ws(mxml_node_t *node, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, mxml_ws_t ws, int col);
 
 
+//
+// 'mxmlLoadBuffer()' - Load a memory buffer into an XML node tree.
+//
+// This function loads `datalen` bytes of XML data from `data` into an XML node
+// tree.  The data does not need to be nul-terminated, which allows network
+// frames and slices of larger buffers to be loaded without copying them.  The
+// nodes in the specified buffer are added to the specified node `top` - if
+// `NULL` the XML data MUST be well-formed with a single parent processing
+// instruction node like `<?xml version="1.0"?>` at the start of the data.
+//
+// Load options are provides via the `options` argument.  If `NULL`, all values
+// will be loaded into `MXML_TYPE_TEXT` nodes.  Use the @link mxmlOptionsNew@
+// function to create options when loading XML data.
+//
+
+mxml_node_t *				// O - First node or `NULL` if the data has errors.
+mxmlLoadBuffer(
+    mxml_node_t    *top,		// I - Top node
+    mxml_options_t *options,		// I - Options
+    const void     *data,		// I - Data to load
+    size_t         datalen)		// I - Length of data in bytes
+{
+  // Range check input...
+  if (!data)
+    return (NULL);
+
+  // Read the XML data...
+  return (mxml_load_memory(top, options, data, datalen, /*mapped*/false));
+}
+
+
 //
 // 'mxmlLoadFd()' - Load a file descriptor into an XML node tree.
 //
@@ -72,6 +603,11 @@ static int		mxml_write_ws(mxml_node_t *node, mxml_options_t *options, mxml_io_cb
 // the XML file MUST be well-formed with a single parent processing instruction
 // node like `<?xml version="1.0"?>` at the start of the file.
 //
+// The data is read in blocks.  When loading stops, the file descriptor is
+// moved back to just after the last character that was parsed if it can seek.
+// For pipes, sockets, and compressed data, bytes after that point may have
+// been read and are lost.
+//
 // Load options are provides via the `options` argument.  If `NULL`, all values
 // will be loaded into `MXML_TYPE_TEXT` nodes.  Use the @link mxmlOptionsNew@
 // function to create options when loading XML data.
@@ -88,7 +624,7 @@ mxmlLoadFd(
     return (NULL);
 
   // Read the XML data...
-  return (mxml_load_data(top, options, (mxml_io_cb_t)mxml_read_cb_fd, &fd));
+  return (mxml_load_io(top, options, (mxml_io_cb_t)mxml_read_cb_fd, &fd));
 }
 
 
@@ -100,6 +636,11 @@ mxmlLoadFd(
 // the XML file MUST be well-formed with a single parent processing instruction
 // node like `<?xml version="1.0"?>` at the start of the file.
 //
+// The data is read in blocks.  When loading stops, the file is moved back to
+// just after the last character that was parsed if it can seek.  For pipes,
+// sockets, and compressed data, bytes after that point may have been read and
+// are lost.
+//
 // Load options are provides via the `options` argument.  If `NULL`, all values
 // will be loaded into `MXML_TYPE_TEXT` nodes.  Use the @link mxmlOptionsNew@
 // function to create options when loading XML data.
@@ -116,7 +657,7 @@ mxmlLoadFile(
     return (NULL);
 
   // Read the XML data...
-  return (mxml_load_data(top, options, (mxml_io_cb_t)mxml_read_cb_file, fp));
+  return (mxml_load_io(top, options, (mxml_io_cb_t)mxml_read_cb_file, fp));
 }
 
 
@@ -139,7 +680,13 @@ mxmlLoadFilename(
     mxml_options_t *options,		// I - Options
     const char     *filename)		// I - File to read from
 {
+#ifdef HAVE_SYS_MMAN_H
+  int		fd;			// File descriptor
+  struct stat	fileinfo;		// File information
+  void		*data;			// Mapped file data
+#else
   FILE		*fp;			// File pointer
+#endif // HAVE_SYS_MMAN_H
   mxml_node_t	*ret;			// Node
 
 
@@ -147,20 +694,154 @@ mxmlLoadFilename(
   if (!filename)
     return (NULL);
 
+#ifdef HAVE_SYS_MMAN_H
+  // Open the file...
+  if ((fd = open(filename, O_RDONLY)) < 0)
+    return (NULL);
+
+  if ((!options || !options->readahead) && !fstat(fd, &fileinfo) && S_ISREG(fileinfo.st_mode) && (fileinfo.st_size > MXML_READ_SIZE || (options && options->lazy && fileinfo.st_size > 0)) && (uintmax_t)fileinfo.st_size <= SIZE_MAX && (data = mmap(NULL, (size_t)fileinfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) != MAP_FAILED)
+  {
+    // Parse directly from the mapped file, which stays mapped if element
+    // contents are loaded later...
+#  ifdef MADV_SEQUENTIAL
+    if (!options || !options->lazy)
+      madvise(data, (size_t)fileinfo.st_size, MADV_SEQUENTIAL);
+#  endif // MADV_SEQUENTIAL
+
+    ret = mxml_load_memory(top, options, data, (size_t)fileinfo.st_size, /*mapped*/true);
+  }
+  else
+  {
+    // Reading ahead, small file, not a regular file, or unable to map, read
+    // the XML data...
+    ret = mxml_load_io(top, options, (mxml_io_cb_t)mxml_read_cb_fd, &fd);
+  }
+
+  // Close the file and return...
+  close(fd);
+
+#else
   // Open the file...
   if ((fp = fopen(filename, "r")) == NULL)
     return (NULL);
 
   // Read the XML data...
-  ret = mxml_load_data(top, options, (mxml_io_cb_t)mxml_read_cb_file, fp);
+  ret = mxml_load_io(top, options, (mxml_io_cb_t)mxml_read_cb_file, fp);
 
   // Close the file and return...
   fclose(fp);
+#endif // HAVE_SYS_MMAN_H
 
   return (ret);
 }
 
 
+//
+// 'mxmlLoadFilenames()' - Load multiple files into XML node trees.
+//
+// This function loads `count` files from the `filenames` array using up to
+// `nthreads` threads, storing the XML node tree for each file in the
+// corresponding element of the `results` array.  Each file is loaded as if by
+// calling @link mxmlLoadFilename@ with a `NULL` top node, and `NULL` is stored
+// for any file that could not be loaded.  If `nthreads` is `0`, one thread is
+// used for each available processor.
+//
+// Load options are provides via the `options` argument.  If `NULL`, all values
+// will be loaded into `MXML_TYPE_TEXT` nodes.  Since files are loaded by
+// multiple threads at the same time, any callbacks in the options must be
+// thread-safe.  The string copy/free callbacks of the calling thread (see
+// @link mxmlSetStringCallbacks@) are used for all files and must also be
+// thread-safe.
+//
+// > Note: Files are loaded on the calling thread when Mini-XML is built
+// > without POSIX threads support.
+//
+
+size_t					// O - Number of files loaded
+mxmlLoadFilenames(
+    const char * const *filenames,	// I - Files to read from
+    size_t             count,		// I - Number of files
+    mxml_options_t     *options,	// I - Options
+    size_t             nthreads,	// I - Number of threads or `0` for automatic
+    mxml_node_t        **results)	// O - XML node trees
+{
+  _mxml_batch_t	batch;			// Batch of files to load
+  _mxml_global_t *global;		// Global data
+  size_t	i,			// Looping var
+		loaded;			// Number of files loaded
+#ifdef HAVE_PTHREAD_H
+  pthread_t	*threads;		// Worker threads
+  size_t	num_threads = 0;	// Number of worker threads
+#endif // HAVE_PTHREAD_H
+
+
+  // Range check input...
+  if (!filenames || !results)
+    return (0);
+
+  // Setup the batch, using this thread's string callbacks for all files...
+  global = _mxml_global();
+
+  batch.filenames  = filenames;
+  batch.count      = count;
+  batch.next       = 0;
+  batch.options    = options;
+  batch.results    = results;
+  batch.strcopy_cb = global->strcopy_cb;
+  batch.strfree_cb = global->strfree_cb;
+  batch.str_cbdata = global->str_cbdata;
+
+#ifdef HAVE_PTHREAD_H
+  // Start worker threads to help this thread load the files...
+  if (nthreads == 0)
+    nthreads = mxml_cpu_count();
+
+  if (nthreads > count)
+    nthreads = count;
+
+  pthread_mutex_init(&batch.mutex, NULL);
+
+  if (nthreads > 1 && (threads = calloc(nthreads - 1, sizeof(pthread_t))) != NULL)
+  {
+    for (; num_threads < (nthreads - 1); num_threads ++)
+    {
+      if (pthread_create(threads + num_threads, NULL, (void *(*)(void *))mxml_load_batch, &batch))
+        break;
+    }
+  }
+  else
+  {
+    threads = NULL;
+  }
+
+  mxml_load_batch(&batch);
+
+  // Wait for the worker threads to finish...
+  for (i = 0; i < num_threads; i ++)
+    pthread_join(threads[i], NULL);
+
+  free(threads);
+
+  pthread_mutex_destroy(&batch.mutex);
+
+#else
+  // Load the files on this thread...
+  (void)nthreads;
+
+  mxml_load_batch(&batch);
+#endif // HAVE_PTHREAD_H
+
+  // Count the files that were loaded...
+  for (i = 0, loaded = 0; i < count; i ++)
+  {
+    if (results[i])
+      loaded ++;
+  }
+
+  return (loaded);
+}
+
+
 //
 // 'mxmlLoadIO()' - Load an XML node tree using a read callback.
 //
@@ -186,6 +867,9 @@ mxmlLoadFilename(
 // }
 // ```
 //
+// The callback is asked for whole blocks of data, so it may provide bytes past
+// the end of the document that are not parsed.
+//
 
 mxml_node_t *				// O - First node or `NULL` if the file could not be read.
 mxmlLoadIO(
@@ -199,7 +883,67 @@ mxmlLoadIO(
     return (NULL);
 
   // Read the XML data...
-  return (mxml_load_data(top, options, io_cb, io_cbdata));
+  return (mxml_load_io(top, options, io_cb, io_cbdata));
+}
+
+
+//
+// 'mxmlLoadNext()' - Load the next document from a document stream.
+//
+// This function loads the next XML document from a stream created with the
+// @link mxmlStreamNewBuffer@, @link mxmlStreamNewFd@,
+// @link mxmlStreamNewFile@, or @link mxmlStreamNewIO@ functions.  Documents
+// follow each other in the data, optionally separated by whitespace, and each
+// one ends when its root element is closed.  A document can start with a
+// processing instruction node like `<?xml version="1.0"?>` which is then the
+// parent of the root element, just like the `mxmlLoad` functions.
+//
+// `NULL` is returned at the end of the data or if the data has errors, after
+// which all further calls return `NULL`.
+//
+
+mxml_node_t *				// O - Document or `NULL` at the end of the data or on error.
+mxmlLoadNext(mxml_stream_t *stream)	// I - Document stream
+{
+  mxml_node_t	*node;			// Document
+  int		line;			// Current line number
+
+
+  // Range check input...
+  if (!stream || stream->l.state == _MXML_LSTATE_ERROR)
+    return (NULL);
+
+  // Start a new document, continuing with the current read buffer...
+  line = stream->l.line;
+
+  mxml_load_reset(&stream->l, /*top*/NULL, stream->options);
+
+  stream->l.line = line;
+
+  if (!mxml_load_parse(&stream->l, stream->options, &stream->r))
+    return (NULL);
+
+  if (stream->r.error)
+  {
+    // The data ended early because it could not be read...
+    _mxml_error(stream->options, "%s", stream->r.error);
+
+    mxmlDelete(stream->l.first);
+
+    stream->l.first = NULL;
+    stream->l.state = _MXML_LSTATE_ERROR;
+
+    return (NULL);
+  }
+
+  if ((node = mxml_load_finish(&stream->l, stream->options)) == NULL)
+    stream->l.state = _MXML_LSTATE_ERROR;
+
+  // The nodes now belong to the caller...
+  stream->l.first  = NULL;
+  stream->l.parent = NULL;
+
+  return (node);
 }
 
 
@@ -222,131 +966,124 @@ mxmlLoadString(
     mxml_options_t *options,		// I - Options
     const char     *s)			// I - String to load
 {
-  _mxml_stringbuf_t	sb;		// String buffer
-
-
   // Range check input...
   if (!s)
     return (NULL);
 
-  // Setup string buffer...
-  sb.buffer   = (char *)s;
-  sb.bufptr   = (char *)s;
-  sb.bufsize  = strlen(s);
-  sb.bufalloc = false;
-
   // Read the XML data...
-  return (mxml_load_data(top, options, (mxml_io_cb_t)mxml_read_cb_string, &sb));
+  return (mxml_load_memory(top, options, s, strlen(s), /*mapped*/false));
 }
 
 
 //
-// 'mxmlSaveAllocString()' - Save an XML tree to an allocated string.
-//
-// This function saves the XML tree `node` to an allocated string.  The string
-// should be freed using `free` (or the string free callback set using
-// @link mxmlSetStringCallbacks@) when you are done with it.
-//
-// `NULL` is returned if the node would produce an empty string or if the string
-// cannot be allocated.
+// 'mxmlParserDelete()' - Delete a push parser.
 //
-// Save options are provides via the `options` argument.  If `NULL`, the XML
-// output will be wrapped at column 72 with no additional whitespace.  Use the
-// @link mxmlOptionsNew@ function to create options for saving XML data.
+// This function frees the memory used by a push parser.  Any nodes that have
+// been loaded are deleted unless @link mxmlParserFinish@ has been called.
 //
 
-char *					// O - Allocated string or `NULL`
-mxmlSaveAllocString(
-    mxml_node_t    *node,		// I - Node to write
-    mxml_options_t *options)		// I - Options
+void
+mxmlParserDelete(
+    mxml_parser_t *parser)		// I - Push parser
 {
-  _mxml_stringbuf_t	sb;		// String buffer
-
-
-  // Setup a string buffer
-  if ((sb.buffer = malloc(1024)) == NULL)
-    return (NULL);
-
-  sb.bufptr   = sb.buffer;
-  sb.bufsize  = 1024;
-  sb.bufalloc = true;
-
-  // Write the top node...
-  if (mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_string, &sb, 0) < 0)
-  {
-    free(sb.buffer);
-    return (NULL);
-  }
+  if (!parser)
+    return;
 
-  // Nul-terminate the string...
-  *(sb.bufptr) = '\0';
+  mxmlDelete(parser->l.first);
+  mxml_load_free(&parser->l);
 
-  // Return the allocated string...
-  return (sb.buffer);
+  free(parser->data);
+  free(parser->r.utf8);
+  free(parser);
 }
 
 
 //
-// 'mxmlSaveFd()' - Save an XML tree to a file descriptor.
+// 'mxmlParserFeed()' - Push data to a push parser.
 //
-// This function saves the XML tree `node` to a file descriptor.
+// This function parses `datalen` bytes of XML data from `data`.  The data can
+// be split at any point, including in the middle of a tag or a UTF-8/UTF-16
+// character - any partial tag, entity, or character is kept until more data is
+// pushed.  Data that is not part of a complete tag, entity, or character is
+// copied by the parser, so the caller can reuse `data` as soon as this
+// function returns.
 //
-// Save options are provides via the `options` argument.  If `NULL`, the XML
-// output will be wrapped at column 72 with no additional whitespace.  Use the
-// @link mxmlOptionsNew@ function to create options for saving XML data.
+// Nodes are added to the XML node tree (or reported to the SAX callback) as
+// soon as they are complete.  `false` is returned if the data has errors, in
+// which case the nodes that have been loaded are deleted and any further data
+// is ignored.
 //
 
-bool					// O - `true` on success, `false` on error.
-mxmlSaveFd(mxml_node_t    *node,	// I - Node to write
-           mxml_options_t *options,	// I - Options
-           int            fd)		// I - File descriptor to write to
+bool					// O - `true` on success, `false` on error
+mxmlParserFeed(
+    mxml_parser_t *parser,		// I - Push parser
+    const void    *data,		// I - Data to parse
+    size_t        datalen)		// I - Length of data in bytes
 {
-  int		col;			// Final column
+  _mxml_read_t	*r;			// Read buffer
+  size_t	unread;			// Bytes left from the last call
 
 
-  // Write the node...
-  if ((col = mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_fd, &fd, 0)) < 0)
+  // Range check input...
+  if (!parser || (!data && datalen > 0) || parser->l.state == _MXML_LSTATE_ERROR)
     return (false);
 
-  // Make sure the file ends with a newline...
-  if (col > 0)
+  if (parser->l.state == _MXML_LSTATE_DONE || datalen == 0)
+    return (true);
+
+  // Add the data to the read buffer...
+  r      = &parser->r;
+  unread = (size_t)(r->bufend - r->bufptr);
+
+  if (unread > 0)
   {
-    if (write(fd, "\n", 1) < 0)
-      return (false);
-  }
+    // Append the new data to the data left from the last call...
+    if (r->bufptr != parser->data)
+      memmove(parser->data, r->bufptr, unread);
 
-  return (true);
-}
+    if (!mxml_parser_reserve(parser, unread + datalen))
+      return (false);
 
+    memcpy(parser->data + unread, data, datalen);
 
-//
-// 'mxmlSaveFile()' - Save an XML tree to a file.
-//
-// This function saves the XML tree `node` to a stdio `FILE`.
-//
-// Save options are provides via the `options` argument.  If `NULL`, the XML
-// output will be wrapped at column 72 with no additional whitespace.  Use the
-// @link mxmlOptionsNew@ function to create options for saving XML data.
-//
+    r->buffer = parser->data;
+    r->bufptr = parser->data;
+    r->bufend = parser->data + unread + datalen;
 
-bool					// O - `true` on success, `false` on error.
-mxmlSaveFile(
-    mxml_node_t    *node,		// I - Node to write
-    mxml_options_t *options,		// I - Options
-    FILE           *fp)			// I - File to write to
-{
-  int		col;			// Final column
+    // Tags always end with '>', so only read the current tag again if the new
+    // data has one...
+    if (parser->l.state == _MXML_LSTATE_TAG && !memchr(data, '>', datalen))
+      return (true);
+  }
+  else
+  {
+    // Read directly from the new data...
+    r->buffer = (unsigned char *)data;
+    r->bufptr = r->buffer;
+    r->bufend = r->buffer + datalen;
+  }
 
+  r->curptr = NULL;
+  r->curend = NULL;
 
-  // Write the node...
-  if ((col = mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_file, fp, 0)) < 0)
+  // Parse as much as we can...
+  if (!mxml_load_parse(&parser->l, parser->options, r))
     return (false);
 
-  // Make sure the file ends with a newline...
-  if (col > 0)
+  // Copy any unread data so the caller can reuse their buffer...
+  if (r->buffer != parser->data)
   {
-    if (putc('\n', fp) < 0)
+    unread = (size_t)(r->bufend - r->bufptr);
+
+    if (!mxml_parser_reserve(parser, unread))
       return (false);
+
+    if (unread > 0)
+      memcpy(parser->data, r->bufptr, unread);
+
+    r->buffer = parser->data;
+    r->bufptr = parser->data;
+    r->bufend = parser->data + unread;
   }
 
   return (true);
@@ -354,1521 +1091,6730 @@ mxmlSaveFile(
 
 
 //
-// 'mxmlSaveFilename()' - Save an XML tree to a file.
-//
-// This function saves the XML tree `node` to a named file.
+// 'mxmlParserFinish()' - Finish parsing with a push parser.
 //
-// Save options are provides via the `options` argument.  If `NULL`, the XML
-// output will be wrapped at column 72 with no additional whitespace.  Use the
-// @link mxmlOptionsNew@ function to create options for saving XML data.
+// This function parses any remaining data and returns the XML node tree, just
+// like the `mxmlLoad` functions.  The returned nodes are not deleted by
+// @link mxmlParserDelete@.
 //
 
-bool					// O - `true` on success, `false` on error.
-mxmlSaveFilename(
-    mxml_node_t    *node,		// I - Node to write
-    mxml_options_t *options,		// I - Options
-    const char     *filename)		// I - File to write to
+mxml_node_t *				// O - First node or `NULL` if the data has errors.
+mxmlParserFinish(
+    mxml_parser_t *parser)		// I - Push parser
 {
-  bool		ret = true;		// Return value
-  FILE		*fp;			// File pointer
-  int		col;			// Final column
+  mxml_node_t	*node;			// First node
 
 
-  // Open the file...
-  if ((fp = fopen(filename, "w")) == NULL)
-    return (false);
+  // Range check input...
+  if (!parser)
+    return (NULL);
 
-  // Write the node...
-  if ((col = mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_file, fp, 0)) < 0)
-  {
-    ret = false;
-  }
-  else if (col > 0)
-  {
-    // Make sure the file ends with a newline...
-    if (putc('\n', fp) < 0)
-      ret = false;
-  }
+  // Parse the remaining data, which is now the end of the XML data...
+  parser->r.partial = false;
+  parser->r.curptr  = NULL;
+  parser->r.curend  = NULL;
 
-  fclose(fp);
+  if (!mxml_load_parse(&parser->l, parser->options, &parser->r))
+    return (NULL);
 
-  return (ret);
+  node = mxml_load_finish(&parser->l, parser->options);
+
+  // The nodes now belong to the caller...
+  parser->l.first  = NULL;
+  parser->l.parent = NULL;
+
+  return (node);
 }
 
 
 //
-// 'mxmlSaveIO()' - Save an XML tree using a callback.
+// 'mxmlParserNew()' - Create a push parser.
 //
-// This function saves the XML tree `node` using a write callback function
-// `io_cb`.  The write callback is called with the callback data pointer
-// `io_cbdata`, a buffer pointer, and the number of bytes to write, for
-// example:
+// This function creates a push parser for loading XML data that arrives in
+// pieces, for example from a non-blocking socket.  Data is pushed to the
+// parser using the @link mxmlParserFeed@ function and the XML node tree is
+// returned by the @link mxmlParserFinish@ function.  The resulting nodes and
+// SAX callbacks are the same as for the `mxmlLoad` functions.
 //
-// ```c
-// size_t my_io_cb(void *cbdata, const void *buffer, size_t bytes)
-// {
-//   ... write/copy bytes from buffer to the output ...
-//   ... return the number of bytes written/copied or 0 on error ...
-// }
-// ```
+// The nodes are added to the specified node `top` - if `NULL` the XML data
+// MUST be well-formed with a single parent processing instruction node like
+// `<?xml version="1.0"?>` at the start of the data.
 //
-// Save options are provides via the `options` argument.  If `NULL`, the XML
-// output will be wrapped at column 72 with no additional whitespace.  Use the
-// @link mxmlOptionsNew@ function to create options for saving XML data.
+// Load options are provides via the `options` argument.  If `NULL`, all values
+// will be loaded into `MXML_TYPE_TEXT` nodes.  The options must not be deleted
+// until the push parser is deleted with @link mxmlParserDelete@.
 //
 
-bool					// O - `true` on success, `false` on error.
-mxmlSaveIO(
-    mxml_node_t    *node,		// I - Node to write
-    mxml_options_t *options,		// I - Options
-    mxml_io_cb_t   io_cb,		// I - Write callback function
-    void           *io_cbdata)		// I - Write callback data
+mxml_parser_t *				// O - Push parser or `NULL` on error
+mxmlParserNew(
+    mxml_node_t    *top,		// I - Top node
+    mxml_options_t *options)		// I - Options
 {
-  int		col;			// Final column
+  mxml_parser_t	*parser;		// Push parser
 
 
-  // Range check input...
-  if (!node || !io_cb)
-    return (false);
+  // Create a new push parser...
+  if ((parser = calloc(1, sizeof(mxml_parser_t))) == NULL)
+  {
+    _mxml_error(options, "Unable to allocate push parser.");
+    return (NULL);
+  }
 
-  // Write the node...
-  if ((col = mxml_write_node(node, options, io_cb, io_cbdata, 0)) < 0)
-    return (false);
+  parser->options    = options;
+  parser->r.encoding = _MXML_ENCODING_UTF8;
+  parser->r.partial  = true;
 
-  if (col > 0)
+  if (!mxml_load_init(&parser->l, top, options))
   {
-    // Make sure the file ends with a newline...
-    if ((io_cb)(io_cbdata, "\n", 1) != 1)
-      return (false);
+    free(parser);
+    return (NULL);
   }
 
-  return (true);
+  return (parser);
 }
 
 
 //
-// 'mxmlSaveString()' - Save an XML node tree to a string.
-//
-// This function saves the XML tree `node` to a fixed-size string buffer.
+// 'mxmlReaderDelete()' - Delete a pull parser.
 //
-// Save options are provides via the `options` argument.  If `NULL`, the XML
-// output will be wrapped at column 72 with no additional whitespace.  Use the
-// @link mxmlOptionsNew@ function to create options for saving XML data.
+// This function frees the memory used by a pull parser.  File descriptors and
+// `FILE` pointers are not closed.
 //
 
-size_t					// O - Size of string
-mxmlSaveString(
-    mxml_node_t    *node,		// I - Node to write
-    mxml_options_t *options,		// I - Options
-    char           *buffer,		// I - String buffer
-    size_t         bufsize)		// I - Size of string buffer
+void
+mxmlReaderDelete(mxml_reader_t *reader)	// I - Pull parser
 {
-  _mxml_stringbuf_t	sb;		// String buffer
+  if (!reader)
+    return;
 
+  mxml_read_free(&reader->r);
 
-  // Setup the string buffer...
-  sb.buffer   = buffer;
-  sb.bufptr   = buffer;
-  sb.bufsize  = bufsize;
-  sb.bufalloc = false;
+  mxml_load_free(&reader->l);
+  free(reader);
+}
 
-  // Write the node...
-  if (mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_string, &sb, 0) < 0)
-    return (false);
 
-  // Nul-terminate the string...
-  if (sb.bufptr < (sb.buffer + sb.bufsize))
-    *(sb.bufptr) = '\0';
+//
+// 'mxmlReaderGetAttrs()' - Get the attributes of the current element.
+//
+// This function returns the attributes of the element opened by the current
+// `MXML_SAX_EVENT_ELEMENT_OPEN` event.  Use the @link mxmlAttrsNext@ function
+// to get each attribute name and value.  Each call starts again with the first
+// attribute.
+//
+// `NULL` is returned for all other events.  The attributes are only valid
+// until the next call to @link mxmlReaderNext@.
+//
 
-  // Return the number of characters...
-  return ((size_t)(sb.bufptr - sb.buffer));
+mxml_attrs_t *				// O - Attributes or `NULL` if not an open element
+mxmlReaderGetAttrs(
+    mxml_reader_t *reader)		// I - Pull parser
+{
+  if (!reader || reader->cur_event >= reader->num_events || reader->events[reader->cur_event] != MXML_SAX_EVENT_ELEMENT_OPEN)
+    return (NULL);
+
+  reader->cur_attrs = reader->attrs;
+
+  return (&reader->cur_attrs);
 }
 
 
 //
-// 'mxml_add_char()' - Add a character to a buffer, expanding as needed.
+// 'mxmlReaderGetData()' - Get the data for the current event.
+//
+// This function returns the element name for `MXML_SAX_EVENT_ELEMENT_OPEN` and
+// `MXML_SAX_EVENT_ELEMENT_CLOSE` events and the text with entities replaced
+// for all other events.  The data is nul-terminated and its length in bytes is
+// returned in `datalen` when not `NULL`.
+//
+// The data points into the pull parser's buffer and is only valid until the
+// next call to @link mxmlReaderNext@.
 //
 
-static bool				// O  - `true` on success, `false` on error
-mxml_add_char(mxml_options_t *options,	// I - Options
-              int            ch,	// I  - Character to add
-              char           **bufptr,	// IO - Current position in buffer
-	      char           **buffer,	// IO - Current buffer
-	      size_t         *bufsize)	// IO - Current buffer size
+const char *				// O - Data or `NULL` if there is no current event
+mxmlReaderGetData(
+    mxml_reader_t *reader,		// I - Pull parser
+    size_t        *datalen)		// O - Length of data in bytes or `NULL`
 {
-  char	*newbuffer;			// New buffer value
+  if (!reader || reader->cur_event >= reader->num_events)
+  {
+    if (datalen)
+      *datalen = 0;
 
+    return (NULL);
+  }
 
-  if (*bufptr >= (*buffer + *bufsize - 4))
-  {
-    // Increase the size of the buffer...
-    if (*bufsize < 1024)
-      (*bufsize) *= 2;
-    else
-      (*bufsize) += 1024;
+  if (datalen)
+    *datalen = reader->datalen[reader->cur_event];
 
-    if ((newbuffer = realloc(*buffer, *bufsize)) == NULL)
-    {
-      _mxml_error(options, "Unable to expand string buffer to %lu bytes.", (unsigned long)*bufsize);
+  return (reader->data[reader->cur_event]);
+}
 
-      return (false);
-    }
 
-    *bufptr = newbuffer + (*bufptr - *buffer);
-    *buffer = newbuffer;
-  }
+//
+// 'mxmlReaderGetEvent()' - Get the current event.
+//
+// This function returns the event read by the last call to
+// @link mxmlReaderNext@, which is one of the events reported to a SAX or
+// event callback.  `MXML_SAX_EVENT_NONE` is returned before the first call to
+// @link mxmlReaderNext@ and after the end of the document or an error.
+//
 
-  if (ch < 0x80)
-  {
-    // Single byte ASCII...
-    *(*bufptr)++ = ch;
-  }
-  else if (ch < 0x800)
-  {
-    // Two-byte UTF-8...
-    *(*bufptr)++ = 0xc0 | (ch >> 6);
-    *(*bufptr)++ = 0x80 | (ch & 0x3f);
-  }
-  else if (ch < 0x10000)
-  {
-    // Three-byte UTF-8...
-    *(*bufptr)++ = 0xe0 | (ch >> 12);
-    *(*bufptr)++ = 0x80 | ((ch >> 6) & 0x3f);
-    *(*bufptr)++ = 0x80 | (ch & 0x3f);
-  }
+mxml_sax_event_t			// O - Current event or `MXML_SAX_EVENT_NONE`
+mxmlReaderGetEvent(
+    mxml_reader_t *reader)		// I - Pull parser
+{
+  if (!reader || reader->cur_event >= reader->num_events)
+    return (MXML_SAX_EVENT_NONE);
   else
-  {
-    // Four-byte UTF-8...
-    *(*bufptr)++ = 0xf0 | (ch >> 18);
-    *(*bufptr)++ = 0x80 | ((ch >> 12) & 0x3f);
-    *(*bufptr)++ = 0x80 | ((ch >> 6) & 0x3f);
-    *(*bufptr)++ = 0x80 | (ch & 0x3f);
-  }
-
-  return (true);
+    return (reader->events[reader->cur_event]);
 }
 
 
 //
-// 'mxml_get_entity()' - Get the character corresponding to an entity...
+// 'mxmlReaderNewBuffer()' - Create a pull parser for a memory buffer.
+//
+// This function creates a pull parser for reading the XML document in the
+// `datalen` bytes at `data` one event at a time with the
+// @link mxmlReaderNext@ function.  The data is parsed in place and must not
+// be freed or changed until the pull parser is deleted with
+// @link mxmlReaderDelete@.
+//
+// Load options are provides via the `options` argument and may be `NULL`.
+// Values are always read as text, and the type, SAX, event, filter, lazy, and
+// thread options are not used.  The options must not be deleted until the
+// pull parser is deleted.
 //
 
-static int				// O  - Character value or `EOF` on error
-mxml_get_entity(
-    mxml_options_t   *options,		// I  - Options
-    mxml_io_cb_t     io_cb,		// I  - Read callback function
-    void             *io_cbdata,	// I  - Read callback data
-    _mxml_encoding_t *encoding,		// IO - Character encoding
-    mxml_node_t      *parent,		// I  - Parent node
-    int              *line)		// IO - Current line number
+mxml_reader_t *				// O - Pull parser or `NULL` on error
+mxmlReaderNewBuffer(
+    mxml_options_t *options,		// I - Options
+    const void     *data,		// I - Data to read
+    size_t         datalen)		// I - Length of data in bytes
 {
-  int	ch;				// Current character
-  char	entity[64],			// Entity string
-	*entptr;			// Pointer into entity
-
+  // Range check input...
+  if (!data)
+    return (NULL);
 
-  // Read a HTML character entity of the form "&NAME;", "&#NUMBER;", or "&#xHEX"...
-  entptr = entity;
+  // Create the pull parser...
+  return (mxml_reader_new(options, -1, /*io_cb*/NULL, /*io_cbdata*/NULL, data, datalen));
+}
 
-  while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF)
-  {
-    if (ch > 126 || (!isalnum(ch) && ch != '#'))
-    {
-      break;
-    }
-    else if (entptr < (entity + sizeof(entity) - 1))
-    {
-      *entptr++ = ch;
-    }
-    else
-    {
-      _mxml_error(options, "Entity name too long under parent <%s> on line %d.", mxmlGetElement(parent), *line);
-      break;
-    }
-  }
 
-  *entptr = '\0';
+//
+// 'mxmlReaderNewFd()' - Create a pull parser for a file descriptor.
+//
+// This function creates a pull parser for reading the XML document from the
+// file descriptor `fd` one event at a time with the @link mxmlReaderNext@
+// function.
+//
+// Load options are provides via the `options` argument and may be `NULL`.
+// Values are always read as text, and the type, SAX, event, filter, lazy, and
+// thread options are not used.  The options must not be deleted until the
+// pull parser is deleted with @link mxmlReaderDelete@.
+//
 
-  if (ch != ';')
-  {
-    _mxml_error(options, "Character entity '%s' not terminated under parent <%s> on line %d.", entity, mxmlGetElement(parent), *line);
+mxml_reader_t *				// O - Pull parser or `NULL` on error
+mxmlReaderNewFd(
+    mxml_options_t *options,		// I - Options
+    int            fd)			// I - File descriptor to read from
+{
+  // Range check input...
+  if (fd < 0)
+    return (NULL);
 
-    if (ch == '\n')
-      (*line)++;
+  // Create the pull parser...
+  return (mxml_reader_new(options, fd, /*io_cb*/NULL, /*io_cbdata*/NULL, /*data*/NULL, 0));
+}
 
-    return (EOF);
-  }
 
-  if ((ch = _mxml_entity_value(options, entity)) < 0)
-  {
-    _mxml_error(options, "Entity '&%s;' not supported under parent <%s> on line %d.", entity, mxmlGetElement(parent), *line);
-    return (EOF);
-  }
+//
+// 'mxmlReaderNewFile()' - Create a pull parser for a file.
+//
+// This function creates a pull parser for reading the XML document from the
+// `FILE` pointer `fp` one event at a time with the @link mxmlReaderNext@
+// function.
+//
+// Load options are provides via the `options` argument and may be `NULL`.
+// Values are always read as text, and the type, SAX, event, filter, lazy, and
+// thread options are not used.  The options must not be deleted until the
+// pull parser is deleted with @link mxmlReaderDelete@.
+//
 
-  if (mxml_bad_char(ch))
-  {
-    _mxml_error(options, "Bad control character 0x%02x under parent <%s> on line %d not allowed by XML standard.", ch, mxmlGetElement(parent), *line);
-    return (EOF);
-  }
+mxml_reader_t *				// O - Pull parser or `NULL` on error
+mxmlReaderNewFile(
+    mxml_options_t *options,		// I - Options
+    FILE           *fp)			// I - File to read from
+{
+  // Range check input...
+  if (!fp)
+    return (NULL);
 
-  return (ch);
+  // Create the pull parser...
+  return (mxml_reader_new(options, -1, (mxml_io_cb_t)mxml_read_cb_file, fp, /*data*/NULL, 0));
 }
 
 
 //
-// 'mxml_getc()' - Read a character from a file descriptor.
+// 'mxmlReaderNewIO()' - Create a pull parser using a read callback.
+//
+// This function creates a pull parser for reading the XML document using the
+// read callback `io_cb` one event at a time with the @link mxmlReaderNext@
+// function.  The read callback is used the same way as for
+// @link mxmlLoadIO@.
+//
+// Load options are provides via the `options` argument and may be `NULL`.
+// Values are always read as text, and the type, SAX, event, filter, lazy, and
+// thread options are not used.  The options must not be deleted until the
+// pull parser is deleted with @link mxmlReaderDelete@.
 //
 
-static int				// O  - Character or `EOF`
-mxml_getc(mxml_options_t   *options,	// I  - Options
-          mxml_io_cb_t     io_cb,	// I  - Read callback function
-          void             *io_cbdata,	// I  - Read callback data
-          _mxml_encoding_t *encoding)	// IO - Encoding
+mxml_reader_t *				// O - Pull parser or `NULL` on error
+mxmlReaderNewIO(
+    mxml_options_t *options,		// I - Options
+    mxml_io_cb_t   io_cb,		// I - Read callback function
+    void           *io_cbdata)		// I - Read callback data
 {
-  int		ch;			// Current character
-  unsigned char	buffer[4];		// Read buffer
+  // Range check input...
+  if (!io_cb)
+    return (NULL);
 
+  // Create the pull parser...
+  return (mxml_reader_new(options, -1, io_cb, io_cbdata, /*data*/NULL, 0));
+}
 
-  // Grab the next character...
-  read_first_byte:
 
-  if ((io_cb)(io_cbdata, buffer, 1) != 1)
-    return (EOF);
+//
+// 'mxmlReaderNext()' - Read the next event from a pull parser.
+//
+// This function reads the XML document up to the next event, which is then
+// available using the @link mxmlReaderGetEvent@, @link mxmlReaderGetData@,
+// and @link mxmlReaderGetAttrs@ functions.  Text is reported as it appears in
+// the document, including whitespace between elements, and an empty element
+// such as "<name/>" is reported as an open event followed by a close event.
+//
+// No nodes are created and the document is only read as far as the current
+// event, so the caller can stop at any point.  `false` is returned at the end
+// of the document or on error.  Errors, including missing close tags, are
+// reported using the error callback.
+//
 
-  ch = buffer[0];
+bool					// O - `true` if an event was read, `false` at the end or on error
+mxmlReaderNext(mxml_reader_t *reader)	// I - Pull parser
+{
+  // Range check input...
+  if (!reader)
+    return (false);
 
-  switch (*encoding)
+  // Use the close event of an empty element...
+  if ((reader->cur_event + 1) < reader->num_events)
   {
-    case _MXML_ENCODING_UTF8 :
-        // Got a UTF-8 character; convert UTF-8 to Unicode and return...
-	if (!(ch & 0x80))
-	{
-	  // ASCII
-	  break;
-        }
-	else if (ch == 0xfe)
-	{
-	  // UTF-16 big-endian BOM?
-	  if ((io_cb)(io_cbdata, buffer + 1, 1) != 1)
-	    return (EOF);
+    reader->cur_event ++;
+    return (true);
+  }
 
-	  if (buffer[1] != 0xff)
-	    return (EOF);
+  reader->num_events = 0;
+  reader->cur_event  = 0;
 
-          // Yes, switch to UTF-16 BE and try reading again...
-	  *encoding = _MXML_ENCODING_UTF16BE;
+  // Parse up to the next event...
+  if (reader->l.state == _MXML_LSTATE_DONE || !mxml_load_parse(&reader->l, &reader->options, &reader->r))
+    return (false);
 
-	  goto read_first_byte;
-	}
-	else if (ch == 0xff)
-	{
-	  // UTF-16 little-endian BOM?
-	  if ((io_cb)(io_cbdata, buffer + 1, 1) != 1)
-	    return (EOF);
-
-	  if (buffer[1] != 0xfe)
-	    return (EOF);
-
-          // Yes, switch to UTF-16 LE and try reading again...
-	  *encoding = _MXML_ENCODING_UTF16LE;
-
-	  goto read_first_byte;
-	}
-	else if ((ch & 0xe0) == 0xc0)
-	{
-	  // Two-byte value...
-	  if ((io_cb)(io_cbdata, buffer + 1, 1) != 1)
-	    return (EOF);
-
-	  if ((buffer[1] & 0xc0) != 0x80)
-	    return (EOF);
+  if (reader->num_events > 0)
+    return (true);
 
-	  ch = ((ch & 0x1f) << 6) | (buffer[1] & 0x3f);
+  // Reached the end of the data, so check for errors...
+  if (reader->r.error)
+    _mxml_error(&reader->options, "%s", reader->r.error);
+  else
+    mxml_load_finish(&reader->l, &reader->options);
 
-	  if (ch < 0x80)
-	  {
-	    _mxml_error(options, "Invalid UTF-8 sequence for character 0x%04x.", ch);
-	    return (EOF);
-	  }
-	}
-	else if ((ch & 0xf0) == 0xe0)
-	{
-	  // Three-byte value...
-	  if ((io_cb)(io_cbdata, buffer + 1, 2) != 2)
-	    return (EOF);
+  return (false);
+}
 
-	  if ((buffer[1] & 0xc0) != 0x80 || (buffer[2] & 0xc0) != 0x80)
-	    return (EOF);
 
-	  ch = ((ch & 0x0f) << 12) | ((buffer[1] & 0x3f) << 6) | (buffer[2] & 0x3f);
+//
+// 'mxmlSaveAllocString()' - Save an XML tree to an allocated string.
+//
+// This function saves the XML tree `node` to an allocated string.  The string
+// should be freed using `free` (or the string free callback set using
+// @link mxmlSetStringCallbacks@) when you are done with it.
+//
+// `NULL` is returned if the node would produce an empty string or if the string
+// cannot be allocated.
+//
+// Save options are provides via the `options` argument.  If `NULL`, the XML
+// output will be wrapped at column 72 with no additional whitespace.  Use the
+// @link mxmlOptionsNew@ function to create options for saving XML data.
+//
 
-	  if (ch < 0x800)
-	  {
-	    _mxml_error(options, "Invalid UTF-8 sequence for character 0x%04x.", ch);
-	    return (EOF);
-	  }
+char *					// O - Allocated string or `NULL`
+mxmlSaveAllocString(
+    mxml_node_t    *node,		// I - Node to write
+    mxml_options_t *options)		// I - Options
+{
+  _mxml_stringbuf_t	sb;		// String buffer
 
-          // Ignore (strip) Byte Order Mark (BOM)...
-	  if (ch == 0xfeff)
-	    goto read_first_byte;
-	}
-	else if ((ch & 0xf8) == 0xf0)
-	{
-	  // Four-byte value...
-	  if ((io_cb)(io_cbdata, buffer + 1, 3) != 3)
-	    return (EOF);
 
-	  if ((buffer[1] & 0xc0) != 0x80 || (buffer[2] & 0xc0) != 0x80 || (buffer[3] & 0xc0) != 0x80)
-	    return (EOF);
+  // Setup a string buffer
+  if ((sb.buffer = malloc(1024)) == NULL)
+    return (NULL);
 
-	  ch = ((ch & 0x07) << 18) | ((buffer[1] & 0x3f) << 12) | ((buffer[2] & 0x3f) << 6) | (buffer[3] & 0x3f);
+  sb.bufptr   = sb.buffer;
+  sb.bufsize  = 1024;
+  sb.bufalloc = true;
 
-	  if (ch < 0x10000)
-	  {
-	    _mxml_error(options, "Invalid UTF-8 sequence for character 0x%04x.", ch);
-	    return (EOF);
-	  }
-	}
-	else
-	{
-	  return (EOF);
-	}
-	break;
+  // Write the top node...
+  if (mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_string, &sb, 0) < 0)
+  {
+    free(sb.buffer);
+    return (NULL);
+  }
 
-    case _MXML_ENCODING_UTF16BE :
-        // Read UTF-16 big-endian char...
-	if ((io_cb)(io_cbdata, buffer + 1, 1) != 1)
-	  return (EOF);
+  // Nul-terminate the string...
+  *(sb.bufptr) = '\0';
 
-	ch = (ch << 8) | buffer[1];
+  // Return the allocated string...
+  return (sb.buffer);
+}
 
-        if (ch >= 0xd800 && ch <= 0xdbff)
-	{
-	  // Multi-word UTF-16 char...
-          int lch;			// Lower bits
 
-	  if ((io_cb)(io_cbdata, buffer + 2, 2) != 2)
-	    return (EOF);
+//
+// 'mxmlSaveFd()' - Save an XML tree to a file descriptor.
+//
+// This function saves the XML tree `node` to a file descriptor.
+//
+// Save options are provides via the `options` argument.  If `NULL`, the XML
+// output will be wrapped at column 72 with no additional whitespace.  Use the
+// @link mxmlOptionsNew@ function to create options for saving XML data.
+//
 
-	  lch = (buffer[2] << 8) | buffer[3];
+bool					// O - `true` on success, `false` on error.
+mxmlSaveFd(mxml_node_t    *node,	// I - Node to write
+           mxml_options_t *options,	// I - Options
+           int            fd)		// I - File descriptor to write to
+{
+  int		col;			// Final column
 
-          if (lch < 0xdc00 || lch >= 0xdfff)
-	    return (EOF);
 
-          ch = (((ch & 0x3ff) << 10) | (lch & 0x3ff)) + 0x10000;
-	}
-	break;
+  // Write the node...
+  if ((col = mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_fd, &fd, 0)) < 0)
+    return (false);
 
-    case _MXML_ENCODING_UTF16LE :
-        // Read UTF-16 little-endian char...
-	if ((io_cb)(io_cbdata, buffer + 1, 1) != 1)
-	  return (EOF);
+  // Make sure the file ends with a newline...
+  if (col > 0)
+  {
+    if (write(fd, "\n", 1) < 0)
+      return (false);
+  }
 
-	ch |= buffer[1] << 8;
+  return (true);
+}
 
-        if (ch >= 0xd800 && ch <= 0xdbff)
-	{
-	  // Multi-word UTF-16 char...
-          int lch;			// Lower bits
 
-	  if ((io_cb)(io_cbdata, buffer + 2, 2) != 2)
-	    return (EOF);
+//
+// 'mxmlSaveFile()' - Save an XML tree to a file.
+//
+// This function saves the XML tree `node` to a stdio `FILE`.
+//
+// Save options are provides via the `options` argument.  If `NULL`, the XML
+// output will be wrapped at column 72 with no additional whitespace.  Use the
+// @link mxmlOptionsNew@ function to create options for saving XML data.
+//
 
-	  lch = (buffer[3] << 8) | buffer[2];
+bool					// O - `true` on success, `false` on error.
+mxmlSaveFile(
+    mxml_node_t    *node,		// I - Node to write
+    mxml_options_t *options,		// I - Options
+    FILE           *fp)			// I - File to write to
+{
+  int		col;			// Final column
 
-          if (lch < 0xdc00 || lch >= 0xdfff)
-	    return (EOF);
 
-          ch = (((ch & 0x3ff) << 10) | (lch & 0x3ff)) + 0x10000;
-	}
-	break;
-  }
+  // Write the node...
+  if ((col = mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_file, fp, 0)) < 0)
+    return (false);
 
-  if (mxml_bad_char(ch))
+  // Make sure the file ends with a newline...
+  if (col > 0)
   {
-    _mxml_error(options, "Bad control character 0x%02x not allowed by XML standard.", ch);
-    return (EOF);
+    if (putc('\n', fp) < 0)
+      return (false);
   }
 
-  return (ch);
+  return (true);
 }
 
 
 //
-// 'mxml_load_data()' - Load data into an XML node tree.
+// 'mxmlSaveFilename()' - Save an XML tree to a file.
+//
+// This function saves the XML tree `node` to a named file.
+//
+// Save options are provides via the `options` argument.  If `NULL`, the XML
+// output will be wrapped at column 72 with no additional whitespace.  Use the
+// @link mxmlOptionsNew@ function to create options for saving XML data.
 //
 
-static mxml_node_t *			// O - First node or `NULL` if the XML could not be read.
-mxml_load_data(
-    mxml_node_t     *top,		// I - Top node
-    mxml_options_t  *options,		// I - Options
-    mxml_io_cb_t    io_cb,		// I - Read callback function
-    void            *io_cbdata)		// I - Read callback data
+bool					// O - `true` on success, `false` on error.
+mxmlSaveFilename(
+    mxml_node_t    *node,		// I - Node to write
+    mxml_options_t *options,		// I - Options
+    const char     *filename)		// I - File to write to
 {
-  mxml_node_t	*node = NULL,		// Current node
-		*first = NULL,		// First node added
-		*parent = NULL;		// Current parent node
-  int		line = 1,		// Current line number
-		ch;			// Character from file
-  bool		whitespace = false;	// Whitespace seen?
-  char		*buffer,		// String buffer
-		*bufptr;		// Pointer into buffer
-  size_t	bufsize;		// Size of buffer
-  mxml_type_t	type;			// Current node type
-  _mxml_encoding_t encoding = _MXML_ENCODING_UTF8;
-					// Character encoding
-  static const char * const types[] =	// Type strings...
-		{
-		  "MXML_TYPE_CDATA",	// CDATA
-		  "MXML_TYPE_COMMENT",	// Comment
-		  "MXML_TYPE_DECLARATION",// Declaration
-		  "MXML_TYPE_DIRECTIVE",// Processing instruction/directive
-		  "MXML_TYPE_ELEMENT",	// XML element with attributes
-		  "MXML_TYPE_INTEGER",	// Integer value
-		  "MXML_TYPE_OPAQUE",	// Opaque string
-		  "MXML_TYPE_REAL",	// Real value
-		  "MXML_TYPE_TEXT",	// Text fragment
-		  "MXML_TYPE_CUSTOM"	// Custom data
-		};
-
-
-  // Read elements and other nodes from the file...
-  if ((buffer = malloc(64)) == NULL)
-  {
-    _mxml_error(options, "Unable to allocate string buffer.");
-    return (NULL);
-  }
+  bool		ret = true;		// Return value
+  FILE		*fp;			// File pointer
+  int		col;			// Final column
 
-  bufsize    = 64;
-  bufptr     = buffer;
-  parent     = top;
-  first      = NULL;
 
-  if (options && options->type_cb && parent)
-    type = (options->type_cb)(options->type_cbdata, parent);
-  else if (options && !options->type_cb)
-    type = options->type_value;
-  else
-    type = MXML_TYPE_IGNORE;
+  // Open the file...
+  if ((fp = fopen(filename, "w")) == NULL)
+    return (false);
 
-  if ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) == EOF)
+  // Write the node...
+  if ((col = mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_file, fp, 0)) < 0)
   {
-    free(buffer);
-    return (NULL);
+    ret = false;
   }
-  else if (ch != '<' && !top)
+  else if (col > 0)
   {
-    free(buffer);
-    _mxml_error(options, "XML does not start with '<' (saw '%c').", ch);
-    return (NULL);
+    // Make sure the file ends with a newline...
+    if (putc('\n', fp) < 0)
+      ret = false;
   }
 
-  do
-  {
-    if ((ch == '<' || (mxml_isspace(ch) && type != MXML_TYPE_OPAQUE && type != MXML_TYPE_CUSTOM)) && bufptr > buffer)
-    {
-      // Add a new value node...
-      *bufptr = '\0';
+  fclose(fp);
 
-      switch (type)
-      {
-	case MXML_TYPE_INTEGER :
-            node = mxmlNewInteger(parent, strtol(buffer, &bufptr, 0));
-	    break;
+  return (ret);
+}
 
-	case MXML_TYPE_OPAQUE :
-            node = mxmlNewOpaque(parent, buffer);
+
+//
+// 'mxmlSaveIO()' - Save an XML tree using a callback.
+//
+// This function saves the XML tree `node` using a write callback function
+// `io_cb`.  The write callback is called with the callback data pointer
+// `io_cbdata`, a buffer pointer, and the number of bytes to write, for
+// example:
+//
+// ```c
+// size_t my_io_cb(void *cbdata, const void *buffer, size_t bytes)
+// {
+//   ... write/copy bytes from buffer to the output ...
+//   ... return the number of bytes written/copied or 0 on error ...
+// }
+// ```
+//
+// Save options are provides via the `options` argument.  If `NULL`, the XML
+// output will be wrapped at column 72 with no additional whitespace.  Use the
+// @link mxmlOptionsNew@ function to create options for saving XML data.
+//
+
+bool					// O - `true` on success, `false` on error.
+mxmlSaveIO(
+    mxml_node_t    *node,		// I - Node to write
+    mxml_options_t *options,		// I - Options
+    mxml_io_cb_t   io_cb,		// I - Write callback function
+    void           *io_cbdata)		// I - Write callback data
+{
+  int		col;			// Final column
+
+
+  // Range check input...
+  if (!node || !io_cb)
+    return (false);
+
+  // Write the node...
+  if ((col = mxml_write_node(node, options, io_cb, io_cbdata, 0)) < 0)
+    return (false);
+
+  if (col > 0)
+  {
+    // Make sure the file ends with a newline...
+    if ((io_cb)(io_cbdata, "\n", 1) != 1)
+      return (false);
+  }
+
+  return (true);
+}
+
+
+//
+// 'mxmlSaveString()' - Save an XML node tree to a string.
+//
+// This function saves the XML tree `node` to a fixed-size string buffer.
+//
+// Save options are provides via the `options` argument.  If `NULL`, the XML
+// output will be wrapped at column 72 with no additional whitespace.  Use the
+// @link mxmlOptionsNew@ function to create options for saving XML data.
+//
+
+size_t					// O - Size of string
+mxmlSaveString(
+    mxml_node_t    *node,		// I - Node to write
+    mxml_options_t *options,		// I - Options
+    char           *buffer,		// I - String buffer
+    size_t         bufsize)		// I - Size of string buffer
+{
+  _mxml_stringbuf_t	sb;		// String buffer
+
+
+  // Setup the string buffer...
+  sb.buffer   = buffer;
+  sb.bufptr   = buffer;
+  sb.bufsize  = bufsize;
+  sb.bufalloc = false;
+
+  // Write the node...
+  if (mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_string, &sb, 0) < 0)
+    return (false);
+
+  // Nul-terminate the string...
+  if (sb.bufptr < (sb.buffer + sb.bufsize))
+    *(sb.bufptr) = '\0';
+
+  // Return the number of characters...
+  return ((size_t)(sb.bufptr - sb.buffer));
+}
+
+
+//
+// 'mxmlStreamDelete()' - Delete a document stream.
+//
+// This function frees the memory used by a document stream.  File descriptors
+// and `FILE` pointers are not closed.
+//
+
+void
+mxmlStreamDelete(mxml_stream_t *stream)	// I - Document stream
+{
+  if (!stream)
+    return;
+
+  mxml_read_free(&stream->r);
+
+  mxml_load_free(&stream->l);
+  free(stream);
+}
+
+
+//
+// 'mxmlStreamNewBuffer()' - Create a document stream for a memory buffer.
+//
+// This function creates a stream for loading a series of XML documents from
+// the `datalen` bytes at `data` with the @link mxmlLoadNext@ function.  The
+// data is parsed in place and must not be freed or changed until the stream
+// is deleted with @link mxmlStreamDelete@.
+//
+// Load options are provides via the `options` argument.  If `NULL`, all values
+// will be loaded into `MXML_TYPE_TEXT` nodes.  The options must not be deleted
+// until the stream is deleted.
+//
+
+mxml_stream_t *				// O - Document stream or `NULL` on error
+mxmlStreamNewBuffer(
+    mxml_options_t *options,		// I - Options
+    const void     *data,		// I - Data to load
+    size_t         datalen)		// I - Length of data in bytes
+{
+  // Range check input...
+  if (!data)
+    return (NULL);
+
+  // Create the stream...
+  return (mxml_stream_new(options, -1, /*io_cb*/NULL, /*io_cbdata*/NULL, data, datalen));
+}
+
+
+//
+// 'mxmlStreamNewFd()' - Create a document stream for a file descriptor.
+//
+// This function creates a stream for loading a series of XML documents from
+// the file descriptor `fd` with the @link mxmlLoadNext@ function.  The read
+// buffer is kept between documents, so data that has been read but not used
+// by one document is used for the next.
+//
+// Load options are provides via the `options` argument.  If `NULL`, all values
+// will be loaded into `MXML_TYPE_TEXT` nodes.  The options must not be deleted
+// until the stream is deleted with @link mxmlStreamDelete@.
+//
+
+mxml_stream_t *				// O - Document stream or `NULL` on error
+mxmlStreamNewFd(
+    mxml_options_t *options,		// I - Options
+    int            fd)			// I - File descriptor to read from
+{
+  // Range check input...
+  if (fd < 0)
+    return (NULL);
+
+  // Create the stream...
+  return (mxml_stream_new(options, fd, /*io_cb*/NULL, /*io_cbdata*/NULL, /*data*/NULL, 0));
+}
+
+
+//
+// 'mxmlStreamNewFile()' - Create a document stream for a file.
+//
+// This function creates a stream for loading a series of XML documents from
+// the `FILE` pointer `fp` with the @link mxmlLoadNext@ function.  The read
+// buffer is kept between documents, so data that has been read but not used
+// by one document is used for the next.
+//
+// Load options are provides via the `options` argument.  If `NULL`, all values
+// will be loaded into `MXML_TYPE_TEXT` nodes.  The options must not be deleted
+// until the stream is deleted with @link mxmlStreamDelete@.
+//
+
+mxml_stream_t *				// O - Document stream or `NULL` on error
+mxmlStreamNewFile(
+    mxml_options_t *options,		// I - Options
+    FILE           *fp)			// I - File to read from
+{
+  // Range check input...
+  if (!fp)
+    return (NULL);
+
+  // Create the stream...
+  return (mxml_stream_new(options, -1, (mxml_io_cb_t)mxml_read_cb_file, fp, /*data*/NULL, 0));
+}
+
+
+//
+// 'mxmlStreamNewIO()' - Create a document stream using a read callback.
+//
+// This function creates a stream for loading a series of XML documents using
+// the read callback `io_cb` with the @link mxmlLoadNext@ function.  The read
+// callback is used the same way as for @link mxmlLoadIO@.
+//
+// Load options are provides via the `options` argument.  If `NULL`, all values
+// will be loaded into `MXML_TYPE_TEXT` nodes.  The options must not be deleted
+// until the stream is deleted with @link mxmlStreamDelete@.
+//
+
+mxml_stream_t *				// O - Document stream or `NULL` on error
+mxmlStreamNewIO(
+    mxml_options_t *options,		// I - Options
+    mxml_io_cb_t   io_cb,		// I - Read callback function
+    void           *io_cbdata)		// I - Read callback data
+{
+  // Range check input...
+  if (!io_cb)
+    return (NULL);
+
+  // Create the stream...
+  return (mxml_stream_new(options, -1, io_cb, io_cbdata, /*data*/NULL, 0));
+}
+
+
+//
+// 'mxmlValidateBuffer()' - Check that a memory buffer contains well-formed XML.
+//
+// This function checks that the `datalen` bytes at `data` contain a single
+// well-formed XML document without creating any nodes.  Element names,
+// attributes, entities, characters, and close tags are checked as when
+// loading, in addition to checking for invalid UTF-8 or UTF-16 sequences,
+// duplicate attributes, and elements that are not closed.
+//
+// The document must have exactly one root element with only whitespace,
+// comments, and processing instructions outside it, as required by the XML
+// specification.  This differs from loading with a `NULL` top node, which
+// accepts several elements after an XML declaration but does not accept
+// comments or processing instructions after the root element.
+//
+// The first error is reported using the error callback, and its line number
+// and byte offset in the (decompressed) data are returned in `errline` and
+// `erroffset` when not `NULL`.  Both are set to `0` when there is no error.
+//
+// Load options are provides via the `options` argument and may be `NULL`.  The
+// type, SAX, event, filter, lazy, and thread options are not used.
+//
+
+bool					// O - `true` if well-formed, `false` otherwise
+mxmlValidateBuffer(
+    mxml_options_t *options,		// I - Options
+    const void     *data,		// I - Data to check
+    size_t         datalen,		// I - Length of data in bytes
+    int            *errline,		// O - Line number of error or `NULL`
+    size_t         *erroffset)		// O - Byte offset of error or `NULL`
+{
+  // Range check input...
+  if (!data)
+    return (false);
+
+  // Check the XML data...
+  return (mxml_validate(options, -1, /*io_cb*/NULL, /*io_cbdata*/NULL, data, datalen, errline, erroffset));
+}
+
+
+//
+// 'mxmlValidateFd()' - Check that a file descriptor contains well-formed XML.
+//
+// This function checks that the file descriptor `fd` contains a single
+// well-formed XML document without creating any nodes.  The same checks are
+// made as for @link mxmlValidateBuffer@.
+//
+// The first error is reported using the error callback, and its line number
+// and byte offset in the (decompressed) data are returned in `errline` and
+// `erroffset` when not `NULL`.  Both are set to `0` when there is no error.
+//
+
+bool					// O - `true` if well-formed, `false` otherwise
+mxmlValidateFd(
+    mxml_options_t *options,		// I - Options
+    int            fd,			// I - File descriptor to read from
+    int            *errline,		// O - Line number of error or `NULL`
+    size_t         *erroffset)		// O - Byte offset of error or `NULL`
+{
+  // Range check input...
+  if (fd < 0)
+    return (false);
+
+  // Check the XML data...
+  return (mxml_validate(options, fd, /*io_cb*/NULL, /*io_cbdata*/NULL, /*data*/NULL, 0, errline, erroffset));
+}
+
+
+//
+// 'mxmlValidateFile()' - Check that a file contains well-formed XML.
+//
+// This function checks that the `FILE` pointer `fp` contains a single
+// well-formed XML document without creating any nodes.  The same checks are
+// made as for @link mxmlValidateBuffer@.
+//
+// The first error is reported using the error callback, and its line number
+// and byte offset in the (decompressed) data are returned in `errline` and
+// `erroffset` when not `NULL`.  Both are set to `0` when there is no error.
+//
+
+bool					// O - `true` if well-formed, `false` otherwise
+mxmlValidateFile(
+    mxml_options_t *options,		// I - Options
+    FILE           *fp,			// I - File to read from
+    int            *errline,		// O - Line number of error or `NULL`
+    size_t         *erroffset)		// O - Byte offset of error or `NULL`
+{
+  // Range check input...
+  if (!fp)
+    return (false);
+
+  // Check the XML data...
+  return (mxml_validate(options, -1, (mxml_io_cb_t)mxml_read_cb_file, fp, /*data*/NULL, 0, errline, erroffset));
+}
+
+
+//
+// 'mxmlValidateIO()' - Check that a read callback provides well-formed XML.
+//
+// This function checks that the data from the read callback `io_cb` is a
+// single well-formed XML document without creating any nodes.  The read
+// callback is used the same way as for @link mxmlLoadIO@ and the same checks
+// are made as for @link mxmlValidateBuffer@.
+//
+// The first error is reported using the error callback, and its line number
+// and byte offset in the (decompressed) data are returned in `errline` and
+// `erroffset` when not `NULL`.  Both are set to `0` when there is no error.
+//
+
+bool					// O - `true` if well-formed, `false` otherwise
+mxmlValidateIO(
+    mxml_options_t *options,		// I - Options
+    mxml_io_cb_t   io_cb,		// I - Read callback function
+    void           *io_cbdata,		// I - Read callback data
+    int            *errline,		// O - Line number of error or `NULL`
+    size_t         *erroffset)		// O - Byte offset of error or `NULL`
+{
+  // Range check input...
+  if (!io_cb)
+    return (false);
+
+  // Check the XML data...
+  return (mxml_validate(options, -1, io_cb, io_cbdata, /*data*/NULL, 0, errline, erroffset));
+}
+
+
+//
+// 'mxmlValidateString()' - Check that a string contains well-formed XML.
+//
+// This function checks that the string `s` contains a single well-formed XML
+// document without creating any nodes.  The same checks are made as for
+// @link mxmlValidateBuffer@.
+//
+// The first error is reported using the error callback, and its line number
+// and byte offset in the string are returned in `errline` and `erroffset`
+// when not `NULL`.  Both are set to `0` when there is no error.
+//
+
+bool					// O - `true` if well-formed, `false` otherwise
+mxmlValidateString(
+    mxml_options_t *options,		// I - Options
+    const char     *s,			// I - String to check
+    int            *errline,		// O - Line number of error or `NULL`
+    size_t         *erroffset)		// O - Byte offset of error or `NULL`
+{
+  // Range check input...
+  if (!s)
+    return (false);
+
+  // Check the XML string...
+  return (mxml_validate(options, -1, /*io_cb*/NULL, /*io_cbdata*/NULL, s, strlen(s), errline, erroffset));
+}
+
+
+//
+// '_mxml_lazy_free()' - Free the source range of an element without loading its contents.
+//
+
+void
+_mxml_lazy_free(mxml_node_t *node)	// I - Element node
+{
+  _mxml_lazyrange_t	*range;		// Source range for contents
+
+
+  if (!node || !node->lazy)
+    return;
+
+  range           = (_mxml_lazyrange_t *)node->user_data;
+  node->lazy      = false;
+  node->user_data = NULL;
+
+  mxml_lazy_release(range->lazy);
+  free(range);
+}
+
+
+//
+// '_mxml_lazy_load()' - Load the contents of an element that were skipped.
+//
+// The contents are loaded with the options that were used to load the element,
+// and any elements in them are also skipped until they are accessed.  If the
+// contents have errors, the error is reported and the element is left without
+// children.
+//
+
+void
+_mxml_lazy_load(mxml_node_t *node)	// I - Element node
+{
+  _mxml_lazyrange_t	*range;		// Source range for contents
+  _mxml_lazy_t		*lazy;		// Source data
+  _mxml_read_t		r;		// Read buffer
+  _mxml_load_t		l;		// Load data
+  bool			loaded = false;	// Were the contents loaded?
+
+
+  if (!node || !node->lazy)
+    return;
+
+  range           = (_mxml_lazyrange_t *)node->user_data;
+  lazy            = range->lazy;
+  node->lazy      = false;
+  node->user_data = NULL;
+
+  // Load the contents and close tag under the element...
+  if (mxml_read_open(&r, &lazy->options, /*io_cb*/NULL, /*io_cbdata*/NULL, range->start, (size_t)(range->end - range->start)))
+  {
+    if (mxml_load_init(&l, node, &lazy->options))
+    {
+      l.line = range->line;
+      l.lazy = lazy;
+
+      if (mxml_load_parse(&l, &lazy->options, &r))
+      {
+        loaded = true;
+
+        mxml_load_free(&l);
+      }
+    }
+
+    mxml_read_free(&r);
+  }
+
+  if (!loaded)
+  {
+    // Remove anything that was loaded before the error...
+    while (node->child)
+      mxmlDelete(node->child);
+  }
+
+  mxml_lazy_release(lazy);
+  free(range);
+}
+
+
+//
+// '_mxml_types_new()' - Create a table of value types for element names.
+//
+// Later entries replace earlier entries with the same name.  The new table has
+// a reference count of 1.
+//
+
+_mxml_types_t *				// O - Value types or `NULL` on error
+_mxml_types_new(
+    size_t            num_types,	// I - Number of element names
+    const char * const *names,		// I - Element names
+    const mxml_type_t *types)		// I - Value types
+{
+  _mxml_types_t	*t;			// Value types
+  size_t	i,			// Looping var
+		h;			// Current slot
+
+
+  if ((t = calloc(1, sizeof(_mxml_types_t))) == NULL)
+    return (NULL);
+
+  // Size the table to keep it at most half full...
+  for (t->size = 16; t->size < (2 * num_types); t->size *= 2);
+
+  t->refs = 1;
+
+  if ((t->names = calloc(t->size, sizeof(char *))) == NULL || (t->types = calloc(t->size, sizeof(mxml_type_t))) == NULL)
+  {
+    _mxml_types_release(t);
+    return (NULL);
+  }
+
+  for (i = 0; i < num_types; i ++)
+  {
+    if (!names[i])
+    {
+      _mxml_types_release(t);
+      return (NULL);
+    }
+
+    for (h = mxml_hash_string(names[i]) & (t->size - 1); t->names[h]; h = (h + 1) & (t->size - 1))
+    {
+      if (!strcmp(t->names[h], names[i]))
+        break;
+    }
+
+    if (!t->names[h] && (t->names[h] = strdup(names[i])) == NULL)
+    {
+      _mxml_types_release(t);
+      return (NULL);
+    }
+
+    t->types[h] = types[i];
+  }
+
+  return (t);
+}
+
+
+//
+// 'mxml_add_char()' - Add a character to a buffer, expanding as needed.
+//
+
+static bool				// O  - `true` on success, `false` on error
+mxml_add_char(mxml_options_t *options,	// I - Options
+              int            ch,	// I  - Character to add
+              char           **bufptr,	// IO - Current position in buffer
+	      char           **buffer,	// IO - Current buffer
+	      size_t         *bufsize)	// IO - Current buffer size
+{
+  char	*newbuffer;			// New buffer value
+
+
+  if (*bufptr >= (*buffer + *bufsize - 4))
+  {
+    // Increase the size of the buffer...
+    if (*bufsize < 1024)
+      (*bufsize) *= 2;
+    else
+      (*bufsize) += 1024;
+
+    if ((newbuffer = realloc(*buffer, *bufsize)) == NULL)
+    {
+      _mxml_error(options, "Unable to expand string buffer to %lu bytes.", (unsigned long)*bufsize);
+
+      return (false);
+    }
+
+    *bufptr = newbuffer + (*bufptr - *buffer);
+    *buffer = newbuffer;
+  }
+
+  if (ch < 0x80)
+  {
+    // Single byte ASCII...
+    *(*bufptr)++ = ch;
+  }
+  else if (ch < 0x800)
+  {
+    // Two-byte UTF-8...
+    *(*bufptr)++ = 0xc0 | (ch >> 6);
+    *(*bufptr)++ = 0x80 | (ch & 0x3f);
+  }
+  else if (ch < 0x10000)
+  {
+    // Three-byte UTF-8...
+    *(*bufptr)++ = 0xe0 | (ch >> 12);
+    *(*bufptr)++ = 0x80 | ((ch >> 6) & 0x3f);
+    *(*bufptr)++ = 0x80 | (ch & 0x3f);
+  }
+  else
+  {
+    // Four-byte UTF-8...
+    *(*bufptr)++ = 0xf0 | (ch >> 18);
+    *(*bufptr)++ = 0x80 | ((ch >> 12) & 0x3f);
+    *(*bufptr)++ = 0x80 | ((ch >> 6) & 0x3f);
+    *(*bufptr)++ = 0x80 | (ch & 0x3f);
+  }
+
+  return (true);
+}
+
+
+//
+// 'mxml_add_chars()' - Add a run of UTF-8 characters to a buffer, expanding as needed.
+//
+
+static bool				// O  - `true` on success, `false` on error
+mxml_add_chars(
+    mxml_options_t      *options,	// I  - Options
+    const unsigned char *s,		// I  - Characters to add
+    size_t              len,		// I  - Number of bytes to add
+    char                **bufptr,	// IO - Current position in buffer
+    char                **buffer,	// IO - Current buffer
+    size_t              *bufsize)	// IO - Current buffer size
+{
+  char		*newbuffer;		// New buffer value
+  size_t	used = (size_t)(*bufptr - *buffer),
+					// Bytes used in buffer
+		newsize = *bufsize;	// New buffer size
+
+
+  if ((used + len) >= newsize)
+  {
+    // Increase the size of the buffer, keeping room for a nul terminator...
+    while ((used + len) >= newsize)
+    {
+      if (newsize < 1024)
+        newsize *= 2;
+      else
+        newsize += 1024;
+    }
+
+    if ((newbuffer = realloc(*buffer, newsize)) == NULL)
+    {
+      _mxml_error(options, "Unable to expand string buffer to %lu bytes.", (unsigned long)newsize);
+
+      return (false);
+    }
+
+    *bufptr  = newbuffer + used;
+    *buffer  = newbuffer;
+    *bufsize = newsize;
+  }
+
+  memcpy(*bufptr, s, len);
+  *bufptr += len;
+
+  return (true);
+}
+
+
+//
+// 'mxml_check_attrs()' - Check the attributes of an element for duplicates.
+//
+// The attributes are pairs of nul-terminated names and values, as added to the
+// string buffer by @code mxml_parse_attrs@.  Names are compared directly for
+// a few attributes and using a hash table for more.
+//
+
+static bool				// O - `true` if no duplicates, `false` otherwise
+mxml_check_attrs(
+    mxml_options_t *options,		// I - Options
+    _mxml_read_t   *r,			// I - Read buffer
+    const char     *element,		// I - Element name
+    const char     *attrs,		// I - Attribute names and values
+    const char     *end,		// I - End of attributes
+    int            line)		// I - Current line number
+{
+  const char	*name,			// Current attribute name
+		*prev;			// Previous attribute name
+  size_t	count = 0,		// Number of attributes
+		size,			// Number of hash slots (power of 2)
+		*slots,			// Hash slots (offset of name + 1)
+		h;			// Current hash slot
+
+
+  // Count the attributes...
+  for (name = attrs; name < end; name += strlen(name) + 1)
+  {
+    name += strlen(name) + 1;
+    count ++;
+  }
+
+  if (count < MXML_ATTR_HASH)
+  {
+    // Compare each name against the names before it...
+    for (name = attrs; name < end; name += strlen(name) + 1)
+    {
+      for (prev = attrs; prev < name; prev += strlen(prev) + 1)
+      {
+        if (!strcmp(prev, name))
+        {
+	  mxml_load_error(options, r, "Duplicate attribute '%s' in element %s on line %d.", name, element, line);
+	  return (false);
+        }
+
+        prev += strlen(prev) + 1;
+      }
+
+      name += strlen(name) + 1;
+    }
+
+    return (true);
+  }
+
+  // Look for each name in a hash table that is at most half full...
+  for (size = 64; size < (2 * count); size *= 2);
+
+  if ((slots = calloc(size, sizeof(size_t))) == NULL)
+  {
+    mxml_load_error(options, r, "Unable to allocate memory for attributes.");
+    return (false);
+  }
+
+  for (name = attrs; name < end; name += strlen(name) + 1)
+  {
+    for (h = mxml_hash_string(name) & (size - 1); slots[h]; h = (h + 1) & (size - 1))
+    {
+      if (!strcmp(attrs + slots[h] - 1, name))
+      {
+	mxml_load_error(options, r, "Duplicate attribute '%s' in element %s on line %d.", name, element, line);
+	free(slots);
+	return (false);
+      }
+    }
+
+    slots[h] = (size_t)(name - attrs) + 1;
+    name     += strlen(name) + 1;
+  }
+
+  free(slots);
+
+  return (true);
+}
+
+
+#ifdef HAVE_PTHREAD_H
+//
+// 'mxml_cpu_count()' - Get the number of available processors.
+//
+
+static size_t				// O - Number of processors
+mxml_cpu_count(void)
+{
+#  ifdef _SC_NPROCESSORS_ONLN
+  long	ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+					// Number of processors
+
+
+  return (ncpus > 0 ? (size_t)ncpus : 1);
+#  else
+  return (1);
+#  endif // _SC_NPROCESSORS_ONLN
+}
+#endif // HAVE_PTHREAD_H
+
+
+//
+// 'mxml_find_close()' - Find the close tag for an element.
+//
+// The markup is scanned from the start of the element's contents, skipping
+// comments, CDATA, processing instructions, declarations, and the quoted
+// attribute values of nested elements.  Since the markup is not parsed, the
+// caller checks the name in the close tag.
+//
+
+static const unsigned char *		// O - Start of close tag or `NULL` if not found
+mxml_find_close(
+    const unsigned char *ptr,		// I - Start of element contents
+    const unsigned char *end)		// I - End of data
+{
+  int	depth = 0,			// Depth of nested elements
+	quote;				// Current quote character
+
+
+  while (ptr && (ptr = memchr(ptr, '<', (size_t)(end - ptr))) != NULL)
+  {
+    if ((end - ptr) < 2)
+      return (NULL);
+
+    if (ptr[1] == '/')
+    {
+      // Close tag...
+      if (depth == 0)
+        return (ptr);
+
+      depth --;
+      ptr = mxml_find_string(ptr + 2, end, ">");
+    }
+    else if (ptr[1] == '?')
+    {
+      // Processing instruction...
+      ptr = mxml_find_string(ptr + 2, end, "?>");
+    }
+    else if ((end - ptr) >= 4 && !memcmp(ptr, "<!--", 4))
+    {
+      // Comment...
+      ptr = mxml_find_string(ptr + 4, end, "-->");
+    }
+    else if ((end - ptr) >= 9 && !memcmp(ptr, "<![CDATA[", 9))
+    {
+      // CDATA...
+      ptr = mxml_find_string(ptr + 9, end, "]]>");
+    }
+    else if (ptr[1] == '!')
+    {
+      // Declaration...
+      ptr = mxml_find_string(ptr + 2, end, ">");
+    }
+    else
+    {
+      // Open tag, which may contain quoted '>' characters...
+      for (ptr ++, quote = 0; ptr < end; ptr ++)
+      {
+        if (quote)
+        {
+          if (*ptr == quote)
+            quote = 0;
+        }
+        else if (*ptr == '\"' || *ptr == '\'')
+          quote = *ptr;
+        else if (*ptr == '>')
+          break;
+      }
+
+      if (ptr >= end)
+        return (NULL);
+
+      if (ptr[-1] != '/')
+        depth ++;
+
+      ptr ++;
+    }
+  }
+
+  return (NULL);
+}
+
+
+#ifdef HAVE_PTHREAD_H
+//
+// 'mxml_find_split()' - Find a place to split the children of the root element.
+//
+// The split is placed after the '>' before the next element called `name` so
+// that any whitespace between the elements stays with the element that
+// follows.  The split is only a guess since the markup is not parsed, and is
+// confirmed by loading the chunk that ends with it.
+//
+
+static const unsigned char *		// O - Split or `NULL` if none
+mxml_find_split(
+    const unsigned char *ptr,		// I - Where to start looking
+    const unsigned char *end,		// I - End of data
+    const unsigned char *name,		// I - Element name
+    size_t              namelen)	// I - Length of element name
+{
+  const unsigned char	*start = ptr,	// Start of search
+			*back;		// Pointer before element
+
+
+  while ((ptr = memchr(ptr, '<', (size_t)(end - ptr))) != NULL)
+  {
+    if ((size_t)(end - ptr) > (namelen + 1) && !memcmp(ptr + 1, name, namelen) && (mxml_isspace(ptr[namelen + 1]) || ptr[namelen + 1] == '/' || ptr[namelen + 1] == '>'))
+    {
+      // Found the element, now look for the end of the markup before it...
+      for (back = ptr; back > start && back[-1] != '>' && back[-1] != '<'; back --);
+
+      if (back > start && back[-1] == '>')
+        return (back);
+    }
+
+    ptr ++;
+  }
+
+  return (NULL);
+}
+#endif // HAVE_PTHREAD_H
+
+
+//
+// 'mxml_find_string()' - Find a string in memory.
+//
+
+static const unsigned char *		// O - Pointer after string or `NULL` if not found
+mxml_find_string(
+    const unsigned char *ptr,		// I - Where to start looking
+    const unsigned char *end,		// I - End of data
+    const char          *s)		// I - String to find
+{
+  size_t	len = strlen(s);	// Length of string
+
+
+  while ((ptr = memchr(ptr, *s, (size_t)(end - ptr))) != NULL)
+  {
+    if ((size_t)(end - ptr) < len)
+      break;
+    else if (!memcmp(ptr, s, len))
+      return (ptr + len);
+
+    ptr ++;
+  }
+
+  return (NULL);
+}
+
+
+//
+// 'mxml_get_entity()' - Get the character corresponding to an entity...
+//
+
+static int				// O  - Character value or `EOF` on error
+mxml_get_entity(
+    mxml_options_t   *options,		// I  - Options
+    _mxml_read_t     *r,		// I  - Read buffer
+    const char       *parent,		// I  - Parent element name
+    int              *line)		// IO - Current line number
+{
+  int	ch;				// Current character
+  char	entity[64],			// Entity string
+	*entptr;			// Pointer into entity
+
+
+  // Read a HTML character entity of the form "&NAME;", "&#NUMBER;", or "&#xHEX"...
+  entptr = entity;
+
+  while ((ch = mxml_getc(options, r)) != EOF)
+  {
+    if (ch > 126 || (!isalnum(ch) && ch != '#'))
+    {
+      break;
+    }
+    else if (entptr < (entity + sizeof(entity) - 1))
+    {
+      *entptr++ = ch;
+    }
+    else
+    {
+      mxml_load_error(options, r, "Entity name too long under parent <%s> on line %d.", parent, *line);
+      break;
+    }
+  }
+
+  *entptr = '\0';
+
+  if (ch != ';')
+  {
+    mxml_load_error(options, r, "Character entity '%s' not terminated under parent <%s> on line %d.", entity, parent, *line);
+
+    if (ch == '\n')
+      (*line)++;
+
+    return (EOF);
+  }
+
+  if ((ch = _mxml_entity_value(options, entity)) < 0)
+  {
+    mxml_load_error(options, r, "Entity '&%s;' not supported under parent <%s> on line %d.", entity, parent, *line);
+    return (EOF);
+  }
+
+  if (mxml_bad_char(ch))
+  {
+    mxml_load_error(options, r, "Bad control character 0x%02x under parent <%s> on line %d not allowed by XML standard.", ch, parent, *line);
+    return (EOF);
+  }
+
+  return (ch);
+}
+
+
+//
+// 'mxml_getc()' - Read a character from a file descriptor.
+//
+
+static int				// O  - Character or `EOF`
+mxml_getc(mxml_options_t *options,	// I  - Options
+          _mxml_read_t   *r)		// I  - Read buffer
+{
+  int		ch;			// Current character
+  unsigned char	buffer[4],		// Read buffer
+		*bufstart;		// Start of character in buffer
+  size_t	offset;			// Byte offset of character
+  _mxml_encoding_t encoding;		// Encoding at start of character
+
+
+  // Decode validated UTF-8 without any further checks...
+  if (r->curptr < r->curend || mxml_read_validate(r))
+  {
+    ch = *(r->curptr)++;
+
+    if (ch < 0x80)
+    {
+      // ASCII
+      return (ch);
+    }
+    else if ((ch & 0xe0) == 0xc0)
+    {
+      // Two-byte value...
+      ch = ((ch & 0x1f) << 6) | (r->curptr[0] & 0x3f);
+      r->curptr ++;
+    }
+    else if ((ch & 0xf0) == 0xe0)
+    {
+      // Three-byte value...
+      ch = ((ch & 0x0f) << 12) | ((r->curptr[0] & 0x3f) << 6) | (r->curptr[1] & 0x3f);
+      r->curptr += 2;
+    }
+    else
+    {
+      // Four-byte value...
+      ch = ((ch & 0x07) << 18) | ((r->curptr[0] & 0x3f) << 12) | ((r->curptr[1] & 0x3f) << 6) | (r->curptr[2] & 0x3f);
+      r->curptr += 3;
+    }
+
+    return (ch);
+  }
+
+  // Grab the next character...
+  bufstart = r->bufptr;
+  encoding = r->encoding;
+  offset   = r->offset + (size_t)(r->bufptr - r->buffer);
+
+  read_first_byte:
+
+  if (!mxml_read_bytes(r, buffer, 1))
+    goto no_data;
+
+  ch = buffer[0];
+
+  switch (r->encoding)
+  {
+    case _MXML_ENCODING_UTF8 :
+        // Got a UTF-8 character; convert UTF-8 to Unicode and return...
+	if (!(ch & 0x80))
+	{
+	  // ASCII
+	  break;
+        }
+	else if (ch == 0xfe)
+	{
+	  // UTF-16 big-endian BOM?
+	  if (!mxml_read_bytes(r, buffer + 1, 1))
+	    goto short_data;
+
+	  if (buffer[1] != 0xff)
+	    goto bad_data;
+
+          // Yes, switch to UTF-16 BE and try reading again...
+	  r->encoding = _MXML_ENCODING_UTF16BE;
+
+	  goto read_first_byte;
+	}
+	else if (ch == 0xff)
+	{
+	  // UTF-16 little-endian BOM?
+	  if (!mxml_read_bytes(r, buffer + 1, 1))
+	    goto short_data;
+
+	  if (buffer[1] != 0xfe)
+	    goto bad_data;
+
+          // Yes, switch to UTF-16 LE and try reading again...
+	  r->encoding = _MXML_ENCODING_UTF16LE;
+
+	  goto read_first_byte;
+	}
+	else if ((ch & 0xe0) == 0xc0)
+	{
+	  // Two-byte value...
+	  if (!mxml_read_bytes(r, buffer + 1, 1))
+	    goto short_data;
+
+	  if ((buffer[1] & 0xc0) != 0x80)
+	    goto bad_data;
+
+	  ch = ((ch & 0x1f) << 6) | (buffer[1] & 0x3f);
+
+	  if (ch < 0x80)
+	  {
+	    mxml_load_error(options, r, "Invalid UTF-8 sequence for character 0x%04x.", ch);
+	    return (EOF);
+	  }
+	}
+	else if ((ch & 0xf0) == 0xe0)
+	{
+	  // Three-byte value...
+	  if (!mxml_read_bytes(r, buffer + 1, 2))
+	    goto short_data;
+
+	  if ((buffer[1] & 0xc0) != 0x80 || (buffer[2] & 0xc0) != 0x80)
+	    goto bad_data;
+
+	  ch = ((ch & 0x0f) << 12) | ((buffer[1] & 0x3f) << 6) | (buffer[2] & 0x3f);
+
+	  if (ch < 0x800)
+	  {
+	    mxml_load_error(options, r, "Invalid UTF-8 sequence for character 0x%04x.", ch);
+	    return (EOF);
+	  }
+
+          // Ignore (strip) Byte Order Mark (BOM)...
+	  if (ch == 0xfeff)
+	    goto read_first_byte;
+	}
+	else if ((ch & 0xf8) == 0xf0)
+	{
+	  // Four-byte value...
+	  if (!mxml_read_bytes(r, buffer + 1, 3))
+	    goto short_data;
+
+	  if ((buffer[1] & 0xc0) != 0x80 || (buffer[2] & 0xc0) != 0x80 || (buffer[3] & 0xc0) != 0x80)
+	    goto bad_data;
+
+	  ch = ((ch & 0x07) << 18) | ((buffer[1] & 0x3f) << 12) | ((buffer[2] & 0x3f) << 6) | (buffer[3] & 0x3f);
+
+	  if (ch < 0x10000)
+	  {
+	    mxml_load_error(options, r, "Invalid UTF-8 sequence for character 0x%04x.", ch);
+	    return (EOF);
+	  }
+	}
+	else
+	{
+	  goto bad_data;
+	}
+	break;
+
+    case _MXML_ENCODING_UTF16BE :
+        // Read UTF-16 big-endian char...
+	if (!mxml_read_bytes(r, buffer + 1, 1))
+	  goto short_data;
+
+	ch = (ch << 8) | buffer[1];
+
+        if (ch >= 0xd800 && ch <= 0xdbff)
+	{
+	  // Multi-word UTF-16 char...
+          int lch;			// Lower bits
+
+	  if (!mxml_read_bytes(r, buffer + 2, 2))
+	    goto short_data;
+
+	  lch = (buffer[2] << 8) | buffer[3];
+
+          if (lch < 0xdc00 || lch >= 0xdfff)
+	    goto bad_data;
+
+          ch = (((ch & 0x3ff) << 10) | (lch & 0x3ff)) + 0x10000;
+	}
+	break;
+
+    case _MXML_ENCODING_UTF16LE :
+        // Read UTF-16 little-endian char...
+	if (!mxml_read_bytes(r, buffer + 1, 1))
+	  goto short_data;
+
+	ch |= buffer[1] << 8;
+
+        if (ch >= 0xd800 && ch <= 0xdbff)
+	{
+	  // Multi-word UTF-16 char...
+          int lch;			// Lower bits
+
+	  if (!mxml_read_bytes(r, buffer + 2, 2))
+	    goto short_data;
+
+	  lch = (buffer[3] << 8) | buffer[2];
+
+          if (lch < 0xdc00 || lch >= 0xdfff)
+	    goto bad_data;
+
+          ch = (((ch & 0x3ff) << 10) | (lch & 0x3ff)) + 0x10000;
+	}
+	break;
+  }
+
+  if (mxml_bad_char(ch))
+  {
+    mxml_load_error(options, r, "Bad control character 0x%02x not allowed by XML standard.", ch);
+    return (EOF);
+  }
+
+  return (ch);
+
+  // Invalid UTF-8 or UTF-16 sequence...
+  bad_data:
+
+  if (!r->error)
+  {
+    r->error     = r->encoding == _MXML_ENCODING_UTF8 ? "Invalid UTF-8 sequence." : "Invalid UTF-16 sequence.";
+    r->erroffset = offset;
+  }
+
+  return (EOF);
+
+  // Ran out of data in the middle of a character...
+  short_data:
+
+  if (!r->partial)
+    goto bad_data;
+
+  // Ran out of data...
+  no_data:
+
+  if (r->partial)
+  {
+    // Rewind so the whole character is read once more data is pushed...
+    r->bufptr   = bufstart;
+    r->encoding = encoding;
+    r->starved  = true;
+  }
+
+  return (EOF);
+}
+
+
+//
+// 'mxml_hash_attr()' - Find the hash table slot for an attribute name.
+//
+// The returned slot contains the index of the attribute plus one, or `0` if
+// the element does not have the named attribute.
+//
+
+static size_t *				// O - Hash table slot
+mxml_hash_attr(_mxml_attrhash_t *hash,	// I - Hash table
+               mxml_node_t      *node,	// I - Element node
+               const char       *name)	// I - Attribute name
+{
+  size_t	h = mxml_hash_string(name);
+					// Hash of name
+  size_t	*slot;			// Current slot
+
+
+  // Probe linearly from the hashed slot until we find the name or an empty
+  // slot...
+  for (h &= hash->size - 1, slot = hash->slots + h; *slot; h = (h + 1) & (hash->size - 1), slot = hash->slots + h)
+  {
+    if (!strcmp(node->value.element.attrs[*slot - 1].name, name))
+      break;
+  }
+
+  return (slot);
+}
+
+
+//
+// 'mxml_hash_attrs()' - Grow and fill a hash table for an element's attributes.
+//
+
+static bool				// O - `true` on success, `false` on error
+mxml_hash_attrs(_mxml_attrhash_t *hash,	// I - Hash table
+                mxml_node_t      *node)	// I - Element node
+{
+  size_t	i,			// Looping var
+		size,			// New number of slots
+		*slots;			// New slots
+
+
+  // Keep the table at most half full...
+  for (size = 64; size < (4 * node->value.element.num_attrs); size *= 2);
+
+  if ((slots = calloc(size, sizeof(size_t))) == NULL)
+    return (false);
+
+  free(hash->slots);
+
+  hash->size  = size;
+  hash->slots = slots;
+
+  for (i = 0; i < node->value.element.num_attrs; i ++)
+    *mxml_hash_attr(hash, node, node->value.element.attrs[i].name) = i + 1;
+
+  return (true);
+}
+
+
+//
+// 'mxml_hash_string()' - Compute the FNV-1a hash of a string.
+//
+
+static size_t				// O - Hash value
+mxml_hash_string(const char *s)		// I - String
+{
+  size_t	h = 2166136261U;	// Hash value
+
+
+  for (; *s; s ++)
+    h = (h ^ (unsigned char)*s) * 16777619U;
+
+  return (h);
+}
+
+
+//
+// 'mxml_lazy_release()' - Release a reference to the source data for elements.
+//
+// The source data is freed, along with any mapped file, when the last
+// reference is released.
+//
+
+static void
+mxml_lazy_release(_mxml_lazy_t *lazy)	// I - Source data or `NULL`
+{
+  if (!lazy || -- lazy->refs > 0)
+    return;
+
+  _mxml_types_release(lazy->options.types);
+
+#ifdef HAVE_SYS_MMAN_H
+  if (lazy->map)
+    munmap(lazy->map, lazy->maplen);
+#endif // HAVE_SYS_MMAN_H
+
+  free(lazy);
+}
+
+
+//
+// 'mxml_load_batch()' - Load files from a batch until none are left.
+//
+
+static void *				// O - Thread exit status (unused)
+mxml_load_batch(_mxml_batch_t *batch)	// I - Batch of files to load
+{
+  size_t	i;			// Current file
+
+
+  // Use the same string callbacks as the calling thread...
+  mxmlSetStringCallbacks(batch->strcopy_cb, batch->strfree_cb, batch->str_cbdata);
+
+  for (;;)
+  {
+    // Get the next file to load...
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&batch->mutex);
+#endif // HAVE_PTHREAD_H
+
+    i = batch->next ++;
+
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&batch->mutex);
+#endif // HAVE_PTHREAD_H
+
+    if (i >= batch->count)
+      break;
+
+    // Load it...
+    batch->results[i] = mxmlLoadFilename(/*top*/NULL, batch->options, batch->filenames[i]);
+  }
+
+  return (NULL);
+}
+
+
+#ifdef HAVE_PTHREAD_H
+//
+// 'mxml_load_chunk()' - Load a chunk of the children of the root element.
+//
+// The chunk is loaded completely if it ends after a node directly under the
+// root element without any errors, in which case loading the chunk gives the
+// same nodes as loading it after the chunks before it.
+//
+
+static void
+mxml_load_chunk(_mxml_chunk_t *chunk)	// I - Chunk to load
+{
+  _mxml_read_t	r;			// Read buffer
+  _mxml_load_t	l;			// Load data
+
+
+  if (!chunk->container || !mxml_read_open(&r, &chunk->options, /*io_cb*/NULL, /*io_cbdata*/NULL, chunk->start, (size_t)(chunk->end - chunk->start)))
+    return;
+
+  if (mxml_load_init(&l, chunk->container, &chunk->options) && mxml_load_parse(&l, &chunk->options, &r))
+  {
+    chunk->loaded = !chunk->error && l.state == _MXML_LSTATE_DONE && l.parent == chunk->container && l.buflen == 0 && !l.whitespace;
+    chunk->lines  = l.line - 1;
+
+    mxml_load_free(&l);
+  }
+
+  mxml_read_free(&r);
+}
+
+
+//
+// 'mxml_load_chunk_error()' - Record an error while loading a chunk.
+//
+// Errors are reported when the push parser loads the same data again.
+//
+
+static void
+mxml_load_chunk_error(
+    _mxml_chunk_t *chunk,		// I - Chunk
+    const char    *message)		// I - Error message (unused)
+{
+  (void)message;
+
+  chunk->error = true;
+}
+
+
+//
+// 'mxml_load_chunks()' - Load chunks of a document until none are left.
+//
+
+static void *				// O - Thread exit status (unused)
+mxml_load_chunks(
+    _mxml_chunks_t *chunks)		// I - Chunks to load
+{
+  size_t	i;			// Current chunk
+
+
+  // Use the same string callbacks as the calling thread...
+  mxmlSetStringCallbacks(chunks->strcopy_cb, chunks->strfree_cb, chunks->str_cbdata);
+
+  for (;;)
+  {
+    // Get the next chunk to load...
+    pthread_mutex_lock(&chunks->mutex);
+
+    i = chunks->next ++;
+
+    pthread_mutex_unlock(&chunks->mutex);
+
+    if (i >= chunks->count)
+      break;
+
+    // Load it...
+    mxml_load_chunk(chunks->chunks + i);
+  }
+
+  return (NULL);
+}
+#endif // HAVE_PTHREAD_H
+
+
+//
+// 'mxml_load_close()' - Close an element reported to the event callback.
+//
+// The name must match the last open element, which is then removed from the
+// element stack.
+//
+
+static bool				// O - `true` on success, `false` if the name does not match
+mxml_load_close(_mxml_load_t *l,	// I - Load data
+                const char   *name)	// I - Element name
+{
+  char	*top;				// Last open element name
+
+
+  if (l->stacklen == 0)
+    return (false);
+
+  for (top = l->stack + l->stacklen - 1; top > l->stack && top[-1]; top --);
+
+  if (strcmp(top, name))
+    return (false);
+
+  l->stacklen = (size_t)(top - l->stack);
+
+  return (true);
+}
+
+
+//
+// 'mxml_load_data()' - Load data into an XML node tree.
+//
+
+static mxml_node_t *			// O - First node or `NULL` if the XML could not be read.
+mxml_load_data(
+    mxml_node_t     *top,		// I - Top node
+    mxml_options_t  *options,		// I - Options
+    _mxml_read_t    *r,			// I - Read buffer
+    _mxml_lazy_t    *lazy)		// I - Source data for loading element contents later or `NULL`
+{
+  _mxml_load_t	l;			// Load data
+  mxml_node_t	*node;			// Loaded node
+
+
+  if (!mxml_load_init(&l, top, options))
+    return (NULL);
+
+  l.lazy = lazy;
+
+  if (!mxml_load_parse(&l, options, r))
+    return (NULL);
+
+  if (r->error)
+  {
+    // The data ended early because it could not be read...
+    _mxml_error(options, "%s", r->error);
+
+    mxmlDelete(l.first);
+
+    node = NULL;
+  }
+  else
+  {
+    node = mxml_load_finish(&l, options);
+  }
+
+  mxml_load_free(&l);
+
+  return (node);
+}
+
+
+//
+// 'mxml_load_error()' - Report an error while loading data.
+//
+// Errors are not reported after running out of pushed data since the current
+// tag or entity will be read again once more data is pushed.  Errors caused by
+// a read error are not reported either since the read error is reported when
+// loading stops.
+//
+
+static void
+mxml_load_error(
+    mxml_options_t *options,		// I - Options
+    _mxml_read_t   *r,			// I - Read buffer
+    const char     *format,		// I - Printf-style format string
+    ...)				// I - Additional arguments as needed
+{
+  va_list	ap;			// Pointer to arguments
+  char		s[1024];		// Message string
+
+
+  if (r->starved || r->error)
+    return;
+
+  va_start(ap, format);
+  vsnprintf(s, sizeof(s), format, ap);
+  va_end(ap);
+
+  _mxml_error(options, "%s", s);
+}
+
+
+//
+// 'mxml_load_filter()' - Match an element against the filter paths.
+//
+// The element names are collected from the root element down to the new
+// element, which is then matched against each path.  Elements directly under
+// the top node are never skipped so that a document always has a root element.
+//
+
+static _mxml_filter_t			// O - Best match for the element
+mxml_load_filter(
+    _mxml_load_t   *l,			// I - Load data
+    mxml_options_t *options,		// I - Options
+    mxml_node_t    *parent,		// I - Parent node
+    const char     *name)		// I - Element name
+{
+  size_t	i,			// Looping var
+		count;			// Number of element names
+  mxml_node_t	*node;			// Current node
+  _mxml_filter_t match,			// Current match
+		best = _MXML_FILTER_NONE;
+					// Best match
+
+
+  // Count the elements and make room for their names...
+  for (count = 1, node = parent; node && node != l->top && node->type == MXML_TYPE_ELEMENT; node = node->parent)
+    count ++;
+
+  if (count > l->alloc_path)
+  {
+    size_t	alloc_path = count + 16;// New size
+    const char	**path;			// New names
+
+    if ((path = realloc(l->path, alloc_path * sizeof(char *))) == NULL)
+      return (_MXML_FILTER_MATCH);
+
+    l->path       = path;
+    l->alloc_path = alloc_path;
+  }
+
+  // Collect the names from the root element down...
+  l->path[count - 1] = name;
+
+  for (i = count - 1, node = parent; i > 0; node = node->parent)
+    l->path[-- i] = node->value.element.name;
+
+  // Then match each path...
+  for (i = 0; i < options->num_filters && best != _MXML_FILTER_MATCH; i ++)
+  {
+    if ((match = mxml_match_path(options->filters[i], l->path, count)) > best)
+      best = match;
+  }
+
+  if (best == _MXML_FILTER_NONE && count == 1)
+    best = _MXML_FILTER_ANCESTOR;
+
+  return (best);
+}
+
+
+//
+// 'mxml_load_finish()' - Finish loading data into an XML node tree.
+//
+
+static mxml_node_t *			// O - First node or `NULL` if the XML could not be read.
+mxml_load_finish(
+    _mxml_load_t   *l,			// I - Load data
+    mxml_options_t *options)		// I - Options
+{
+  mxml_node_t	*node,			// Current node
+		*parent = l->parent;	// Current parent node
+
+
+  if (l->stacklen > 0)
+  {
+    // Report the last element that was not closed...
+    char *name = l->stack + l->stacklen - 1;
+					// Last open element name
+
+    while (name > l->stack && name[-1])
+      name --;
+
+    _mxml_error(options, "Missing close tag </%s> on line %d.", name, l->line);
+
+    return (NULL);
+  }
+
+  // Find the top element and return it...
+  if (parent)
+  {
+    node = parent;
+
+    while (parent != l->top && parent->parent)
+      parent = parent->parent;
+
+    if (node != parent)
+    {
+      _mxml_error(options, "Missing close tag </%s> under parent <%s> on line %d.", mxmlGetElement(node), node->parent ? node->parent->value.element.name : "(null)", l->line);
+
+      mxmlDelete(l->first);
+
+      return (NULL);
+    }
+  }
+
+  if (parent)
+    return (parent);
+  else
+    return (l->first);
+}
+
+
+//
+// 'mxml_load_free()' - Free the string buffer and element names for loading.
+//
+// Element names that are still used by nodes are freed when those nodes are
+// deleted.
+//
+
+static void
+mxml_load_free(_mxml_load_t *l)		// I - Load data
+{
+  size_t	i;			// Looping var
+
+
+  free(l->buffer);
+
+  for (i = 0; i < l->alloc_names; i ++)
+  {
+    if (l->names[i])
+      _mxml_name_release(l->names[i]->name);
+  }
+
+  free(l->names);
+  free(l->path);
+  free(l->stack);
+
+  l->buffer      = NULL;
+  l->num_names   = 0;
+  l->alloc_names = 0;
+  l->names       = NULL;
+  l->path        = NULL;
+  l->alloc_path  = 0;
+  l->stack       = NULL;
+  l->stacksize   = 0;
+}
+
+
+//
+// 'mxml_load_init()' - Initialize the data for loading an XML node tree.
+//
+
+static bool				// O - `true` on success, `false` on error
+mxml_load_init(
+    _mxml_load_t   *l,			// I - Load data
+    mxml_node_t    *top,		// I - Top node
+    mxml_options_t *options)		// I - Options
+{
+  // Allocate the string buffer...
+  if ((l->buffer = malloc(64)) == NULL)
+  {
+    _mxml_error(options, "Unable to allocate string buffer.");
+    return (false);
+  }
+
+  l->bufsize     = 64;
+  l->line        = 1;
+  l->stream      = false;
+  l->share_names = !_mxml_global()->strcopy_cb;
+  l->num_names   = 0;
+  l->alloc_names = 0;
+  l->names       = NULL;
+  l->lazy        = NULL;
+  l->path        = NULL;
+  l->alloc_path  = 0;
+  l->stack       = NULL;
+  l->stacksize   = 0;
+  l->check_attrs = false;
+
+  mxml_load_reset(l, top, options);
+
+  return (true);
+}
+
+
+//
+// 'mxml_load_parse()' - Parse data into an XML node tree.
+//
+// Parsing continues until the end of the data or an error.  When reading
+// pushed data, parsing stops when the data runs out and resumes with the
+// current character, tag, or entity once more data is pushed.
+//
+
+static bool				// O - `true` on success, `false` on error
+mxml_load_parse(
+    _mxml_load_t    *l,			// I - Load data
+    mxml_options_t  *options,		// I - Options
+    _mxml_read_t    *r)			// I - Read buffer
+{
+  mxml_node_t	*node = NULL,		// Current node
+		*first = l->first,	// First node added
+		*parent = l->parent;	// Current parent node
+  int		line = l->line,		// Current line number
+		ch;			// Character from file
+  bool		whitespace = l->whitespace;
+					// Whitespace seen?
+  char		*buffer = l->buffer,	// String buffer
+		*bufptr = l->buffer + l->buflen;
+					// Pointer into buffer
+  size_t	bufsize = l->bufsize,	// Size of buffer
+		len;			// Length of text run
+  mxml_type_t	type = l->type;		// Current node type
+  _mxml_filter_t filter;		// Filter path match for element
+  static const char * const types[] =	// Type strings...
+		{
+		  "MXML_TYPE_CDATA",	// CDATA
+		  "MXML_TYPE_COMMENT",	// Comment
+		  "MXML_TYPE_DECLARATION",// Declaration
+		  "MXML_TYPE_DIRECTIVE",// Processing instruction/directive
+		  "MXML_TYPE_ELEMENT",	// XML element with attributes
+		  "MXML_TYPE_INTEGER",	// Integer value
+		  "MXML_TYPE_OPAQUE",	// Opaque string
+		  "MXML_TYPE_REAL",	// Real value
+		  "MXML_TYPE_TEXT",	// Text fragment
+		  "MXML_TYPE_CUSTOM"	// Custom data
+		};
+
+
+  // Read elements and other nodes from the file, picking up where we left
+  // off...
+  switch (l->state)
+  {
+    case _MXML_LSTATE_START :
+	while ((ch = mxml_getc(options, r)) != EOF && l->stream && mxml_isspace(ch))
+	{
+	  // Skip whitespace between documents...
+	  if (ch == '\n')
+	    line ++;
+	}
+
+	if (ch == EOF)
+	{
+	  goto error;
+	}
+	else if (ch != '<' && !l->top)
+	{
+	  mxml_load_error(options, r, "XML does not start with '<' (saw '%c').", ch);
+	  goto error;
+	}
+	break;
+
+    case _MXML_LSTATE_CHAR :
+	if ((ch = mxml_getc(options, r)) == EOF)
+	  goto eof;
+	break;
+
+    case _MXML_LSTATE_TAG :
+        // The buffer may have moved, so save the start of the tag again...
+        ch     = '<';
+        l->pos = mxml_read_tell(r);
+        goto read_tag;
+
+    case _MXML_LSTATE_ENTITY :
+        // The buffer may have moved, so save the start of the entity again...
+        ch     = '&';
+        l->pos = mxml_read_tell(r);
+        goto read_entity;
+
+    case _MXML_LSTATE_SKIP :
+        // The buffer may have moved, so save the start of the contents again...
+        ch     = EOF;
+        l->pos = mxml_read_tell(r);
+        goto skip_element;
+
+    case _MXML_LSTATE_COMMENT :
+        // Keep gathering the comment in the string buffer...
+        goto read_comment;
+
+    case _MXML_LSTATE_CDATA :
+        // Keep gathering the CDATA section in the string buffer...
+        goto read_cdata;
+
+    case _MXML_LSTATE_DIRECTIVE :
+        // Keep gathering the processing instruction in the string buffer...
+        goto read_directive;
+
+    case _MXML_LSTATE_DECLARATION :
+        // Keep gathering the declaration in the string buffer, reading any
+        // entity that was cut off again...
+        if (l->pos)
+        {
+          ch     = '&';
+          l->pos = mxml_read_tell(r);
+        }
+        else
+        {
+          ch = mxml_getc(options, r);
+        }
+        goto read_declaration;
+
+    default :
+        return (l->state == _MXML_LSTATE_DONE);
+  }
+
+  do
+  {
+    if (ch == '<' && bufptr > buffer && options && options->event_cb)
+    {
+      // Report text to the event callback...
+      *bufptr = '\0';
+
+      if (!(options->event_cb)(options->event_cbdata, MXML_SAX_EVENT_DATA, buffer, (size_t)(bufptr - buffer), /*attrs*/NULL))
+        goto error;
+
+      bufptr = buffer;
+
+      if (l->paused)
+      {
+        // Stop here and read the tag on the next call...
+        l->state = _MXML_LSTATE_TAG;
+        goto pause;
+      }
+    }
+    else if ((ch == '<' || (mxml_isspace(ch) && type != MXML_TYPE_OPAQUE && type != MXML_TYPE_CUSTOM)) && bufptr > buffer)
+    {
+      // Add a new value node...
+      *bufptr = '\0';
+
+      switch (type)
+      {
+	case MXML_TYPE_INTEGER :
+            node = mxmlNewInteger(parent, mxml_strtol(buffer, &bufptr));
+	    break;
+
+	case MXML_TYPE_OPAQUE :
+            node = mxmlNewOpaque(parent, buffer);
+	    break;
+
+	case MXML_TYPE_REAL :
+            node = mxmlNewReal(parent, mxml_strtod(buffer, &bufptr));
+	    break;
+
+	case MXML_TYPE_TEXT :
+            node = mxmlNewText(parent, whitespace, buffer);
+	    break;
+
+	case MXML_TYPE_CUSTOM :
+	    if (options && options->custload_cb)
+	    {
+	      // Use the callback to fill in the custom data...
+              node = mxmlNewCustom(parent, /*data*/NULL, /*free_cb*/NULL, /*free_cbdata*/NULL);
+
+	      if (!(options->custload_cb)(options->cust_cbdata, node, buffer))
+	      {
+	        mxml_load_error(options, r, "Bad custom value '%s' in parent <%s> on line %d.", buffer, parent ? parent->value.element.name : "null", line);
+		mxmlDelete(node);
+		node = NULL;
+	      }
+	      break;
+	    }
+
+	    // Fall through - ignore custom data without a callback
+
+        default : // Ignore...
+	    node = NULL;
+	    break;
+      }
+
+      if (*bufptr)
+      {
+        // Bad integer/real number value...
+        mxml_load_error(options, r, "Bad %s value '%s' in parent <%s> on line %d.", type == MXML_TYPE_INTEGER ? "integer" : "real", buffer, parent ? parent->value.element.name : "null", line);
+	break;
+      }
+
+      MXML_DEBUG("mxml_load_data: node=%p(%s), parent=%p\n", node, buffer, parent);
+
+      bufptr     = buffer;
+      whitespace = mxml_isspace(ch) && type == MXML_TYPE_TEXT;
+
+      if (!node && type != MXML_TYPE_IGNORE)
+      {
+        // Print error and return...
+	mxml_load_error(options, r, "Unable to add value node of type %s to parent <%s> on line %d.", types[type], parent ? parent->value.element.name : "null", line);
+	goto error;
+      }
+
+      if (node && options && options->sax_cb)
+      {
+        if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_DATA))
+          goto error;
+
+        if (!mxmlRelease(node))
+          node = NULL;
+      }
+
+      if (!first && node)
+        first = node;
+    }
+    else if (mxml_isspace(ch) && type == MXML_TYPE_TEXT)
+    {
+      whitespace = true;
+    }
+
+    if (ch == '\n')
+      line ++;
+
+    // Add lone whitespace node if we have an element and existing whitespace...
+    if (ch == '<' && whitespace && type == MXML_TYPE_TEXT)
+    {
+      if (parent)
+      {
+	node = mxmlNewText(parent, whitespace, "");
+
+	if (options && options->sax_cb)
+	{
+	  if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_DATA))
+	    goto error;
+
+	  if (!mxmlRelease(node))
+	    node = NULL;
+	}
+
+	if (!first && node)
+	  first = node;
+      }
+
+      whitespace = false;
+    }
+
+    if (ch == '<')
+    {
+      // Start of open/close tag...
+      bufptr = buffer;
+
+      if (r->partial)
+      {
+        // Save the start of the tag in case we run out of pushed data...
+        l->state    = _MXML_LSTATE_TAG;
+        l->line     = line;
+        l->buflen   = 0;
+        l->pos      = mxml_read_tell(r);
+        l->encoding = r->encoding;
+      }
+
+      read_tag:
+
+      while ((ch = mxml_getc(options, r)) != EOF)
+      {
+        if (mxml_isspace(ch) || ch == '>' || (ch == '/' && bufptr > buffer))
+        {
+	  break;
+	}
+	else if (ch == '<')
+	{
+	  mxml_load_error(options, r, "Bare < in element.");
+	  goto error;
+	}
+	else if (ch == '&')
+	{
+	  if ((ch = mxml_get_entity(options, r, mxml_load_parent(l, parent), &line)) == EOF)
+	    goto error;
+
+	  if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
+	    goto error;
+	}
+	else if (!(mxml_char_class(ch) & _MXML_CHAR_TAG) && ch != '/')
+	{
+	  goto error;
+	}
+	else if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
+	{
+	  goto error;
+	}
+	else if (((bufptr - buffer) == 1 && buffer[0] == '?') || ((bufptr - buffer) == 3 && !strncmp(buffer, "!--", 3)) || ((bufptr - buffer) == 8 && !strncmp(buffer, "![CDATA[", 8)))
+	{
+	  break;
+	}
+	else if (buffer[0] != '!' && buffer[0] != '?' && !mxml_read_span(options, r, _MXML_CHAR_TAG, &bufptr, &buffer, &bufsize))
+	{
+	  // Copy the rest of the element name...
+	  goto error;
+	}
+
+	if (ch == '\n')
+	  line ++;
+      }
+
+      *bufptr = '\0';
+
+      if (ch == EOF && r->starved)
+        goto starved;
+
+      if (!strcmp(buffer, "!--"))
+      {
+        // Gather rest of comment...
+        if (r->partial)
+          l->state = _MXML_LSTATE_COMMENT;
+
+        read_comment:
+
+	while ((ch = mxml_getc(options, r)) != EOF)
+	{
+	  if (ch == '>' && bufptr > (buffer + 4) && bufptr[-3] != '-' && bufptr[-2] == '-' && bufptr[-1] == '-')
+	    break;
+	  else if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
+	    goto error;
+
+	  if (ch == '\n')
+	    line ++;
+
+	  // Copy everything up to the next possible terminator...
+	  if ((len = mxml_read_until(r, "-->", &line)) > 0)
+	  {
+	    if (!mxml_add_chars(options, r->curptr, len, &bufptr, &buffer, &bufsize))
+	      goto error;
+
+	    r->curptr += len;
+	  }
+	}
+
+        // Error out if we didn't get the whole comment...
+        if (ch != '>')
+	{
+	  // Print error and return...
+	  mxml_load_error(options, r, "Early EOF in comment node on line %d.", line);
+	  goto error;
+	}
+
+        // Otherwise add this as an element under the current parent...
+	bufptr[-2] = '\0';
+
+        if (!parent && first)
+	{
+	  // There can only be one root element!
+	  mxml_load_error(options, r, "<%s--> cannot be a second root node after <%s> on line %d.", buffer, first->value.element.name, line);
+          goto error;
+	}
+
+        if (!mxml_load_keep(l, options, parent))
+        {
+          // Skip nodes outside the filter paths...
+          bufptr = buffer;
+          continue;
+        }
+
+        if (options && options->event_cb)
+        {
+          // Report to the event callback without creating a node...
+          if (!(options->event_cb)(options->event_cbdata, MXML_SAX_EVENT_COMMENT, buffer + 3, (size_t)(bufptr - 2 - buffer - 3), /*attrs*/NULL))
+            goto error;
+
+          bufptr = buffer;
+          continue;
+        }
+
+	if ((node = mxmlNewComment(parent, buffer + 3)) == NULL)
+	{
+	  // Just print error for now...
+	  mxml_load_error(options, r, "Unable to add comment node to parent <%s> on line %d.", parent ? parent->value.element.name : "null", line);
+	  break;
+	}
+
+	MXML_DEBUG("mxml_load_data: node=%p(<%s-->), parent=%p\n", node, buffer, parent);
+
+        if (options && options->sax_cb)
+        {
+          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_COMMENT))
+	    goto error;
+
+          if (!mxmlRelease(node))
+            node = NULL;
+        }
+
+	if (node && !first)
+	  first = node;
+      }
+      else if (!strcmp(buffer, "![CDATA["))
+      {
+        // Gather CDATA section...
+        if (r->partial)
+          l->state = _MXML_LSTATE_CDATA;
+
+        read_cdata:
+
+	while ((ch = mxml_getc(options, r)) != EOF)
+	{
+	  if (ch == '>' && !strncmp(bufptr - 2, "]]", 2))
+	  {
+	    // Drop terminator from CDATA string...
+	    bufptr[-2] = '\0';
+	    break;
+	  }
+	  else if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
+	  {
+	    goto error;
+	  }
+
+	  if (ch == '\n')
+	    line ++;
+
+	  // Copy everything up to the next possible terminator...
+	  if ((len = mxml_read_until(r, "]]>", &line)) > 0)
+	  {
+	    if (!mxml_add_chars(options, r->curptr, len, &bufptr, &buffer, &bufsize))
+	      goto error;
+
+	    r->curptr += len;
+	  }
+	}
+
+        // Error out if we didn't get the whole comment...
+        if (ch != '>')
+	{
+	  // Print error and return...
+	  mxml_load_error(options, r, "Early EOF in CDATA node on line %d.", line);
+	  goto error;
+	}
+
+        // Otherwise add this as an element under the current parent...
+	bufptr[-2] = '\0';
+
+        if (!parent && first)
+	{
+	  // There can only be one root element!
+	  mxml_load_error(options, r, "<%s]]> cannot be a second root node after <%s> on line %d.", buffer, first->value.element.name, line);
+          goto error;
+	}
+
+        if (!mxml_load_keep(l, options, parent))
+        {
+          // Skip nodes outside the filter paths...
+          bufptr = buffer;
+          continue;
+        }
+
+        if (options && options->event_cb)
+        {
+          // Report to the event callback without creating a node...
+          if (!(options->event_cb)(options->event_cbdata, MXML_SAX_EVENT_CDATA, buffer + 8, (size_t)(bufptr - 2 - buffer - 8), /*attrs*/NULL))
+            goto error;
+
+          bufptr = buffer;
+          continue;
+        }
+
+	if ((node = mxmlNewCDATA(parent, buffer + 8)) == NULL)
+	{
+	  // Print error and return...
+	  mxml_load_error(options, r, "Unable to add CDATA node to parent <%s> on line %d.", parent ? parent->value.element.name : "null", line);
+	  goto error;
+	}
+
+	MXML_DEBUG("mxml_load_data: node=%p(<%s]]>), parent=%p\n", node, buffer, parent);
+
+        if (options && options->sax_cb)
+        {
+          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_CDATA))
+	    goto error;
+
+          if (!mxmlRelease(node))
+            node = NULL;
+        }
+
+	if (node && !first)
+	  first = node;
+      }
+      else if (buffer[0] == '?')
+      {
+        // Gather rest of processing instruction...
+        if (r->partial)
+          l->state = _MXML_LSTATE_DIRECTIVE;
+
+        read_directive:
+
+	while ((ch = mxml_getc(options, r)) != EOF)
+	{
+	  if (ch == '>' && bufptr > buffer && bufptr[-1] == '?')
+	    break;
+	  else if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
+	    goto error;
+
+	  if (ch == '\n')
+	    line ++;
+
+	  // Copy everything up to the next possible terminator...
+	  if ((len = mxml_read_until(r, "?>", &line)) > 0)
+	  {
+	    if (!mxml_add_chars(options, r->curptr, len, &bufptr, &buffer, &bufsize))
+	      goto error;
+
+	    r->curptr += len;
+	  }
+	}
+
+        // Error out if we didn't get the whole processing instruction...
+        if (ch != '>')
+	{
+	  // Print error and return...
+	  mxml_load_error(options, r, "Early EOF in processing instruction node on line %d.", line);
+	  goto error;
+	}
+
+        // Otherwise add this as an element under the current parent...
+	bufptr[-1] = '\0';
+
+        if (!parent && first)
+	{
+	  // There can only be one root element!
+	  mxml_load_error(options, r, "<%s?> cannot be a second root node after <%s> on line %d.", buffer, first->value.element.name, line);
+          goto error;
+	}
+
+        if (!mxml_load_keep(l, options, parent))
+        {
+          // Skip nodes outside the filter paths...
+          bufptr = buffer;
+          continue;
+        }
+
+        if (options && options->event_cb)
+        {
+          // Report to the event callback without creating a node...
+          if (!(options->event_cb)(options->event_cbdata, MXML_SAX_EVENT_DIRECTIVE, buffer + 1, (size_t)(bufptr - 1 - buffer - 1), /*attrs*/NULL))
+            goto error;
+
+          bufptr = buffer;
+          continue;
+        }
+
+	if ((node = mxmlNewDirective(parent, buffer + 1)) == NULL)
+	{
+	  // Print error and return...
+	  mxml_load_error(options, r, "Unable to add processing instruction node to parent <%s> on line %d.", parent ? parent->value.element.name : "null", line);
+	  goto error;
+	}
+
+	MXML_DEBUG("mxml_load_data: node=%p(<%s?>), parent=%p\n", node, buffer, parent);
+
+        if (options && options->sax_cb)
+        {
+          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_DIRECTIVE))
+	    goto error;
+
+          if (strncmp(node->value.directive, "xml ", 4) && !mxmlRelease(node))
+            node = NULL;
+        }
+
+        if (node)
+	{
+	  if (!first)
+            first = node;
+
+	  if (!parent)
+	  {
+	    parent = node;
+
+	    if (options)
+	      type = mxml_load_type(options, parent);
+	    else
+	      type = MXML_TYPE_TEXT;
+	  }
+	}
+      }
+      else if (buffer[0] == '!')
+      {
+        // Gather rest of declaration...
+        if (r->partial)
+        {
+          l->state = _MXML_LSTATE_DECLARATION;
+          l->pos   = NULL;
+        }
+
+        read_declaration:
+
+	do
+	{
+	  if (ch == '>' || ch == EOF)
+	  {
+	    break;
+	  }
+	  else
+	  {
+            if (ch == '&')
+            {
+              if (r->partial)
+              {
+                // Save the start of the entity in case we run out of pushed
+                // data...
+                l->line     = line;
+                l->pos      = mxml_read_tell(r);
+                l->encoding = r->encoding;
+              }
+
+	      if ((ch = mxml_get_entity(options, r, mxml_load_parent(l, parent), &line)) == EOF)
+		goto error;
+
+              l->pos = NULL;
+            }
+
+	    if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
+	      goto error;
+	  }
+
+	  if (ch == '\n')
+	    line ++;
+	}
+        while ((ch = mxml_getc(options, r)) != EOF);
+
+        // Error out if we didn't get the whole declaration...
+        if (ch != '>')
+	{
+	  // Print error and return...
+	  mxml_load_error(options, r, "Early EOF in declaration node on line %d.", line);
+	  goto error;
+	}
+
+        // Otherwise add this as an element under the current parent...
+	*bufptr = '\0';
+
+        if (!parent && first)
+	{
+	  // There can only be one root element!
+	  mxml_load_error(options, r, "<%s> cannot be a second root node after <%s> on line %d.", buffer, first->value.element.name, line);
+          goto error;
+	}
+
+        if (!mxml_load_keep(l, options, parent))
+        {
+          // Skip nodes outside the filter paths...
+          bufptr = buffer;
+          continue;
+        }
+
+        if (options && options->event_cb)
+        {
+          // Report to the event callback without creating a node...
+          if (!(options->event_cb)(options->event_cbdata, MXML_SAX_EVENT_DECLARATION, buffer + 1, (size_t)(bufptr - buffer - 1), /*attrs*/NULL))
+            goto error;
+
+          bufptr = buffer;
+          continue;
+        }
+
+	if ((node = mxmlNewDeclaration(parent, buffer + 1)) == NULL)
+	{
+	  // Print error and return...
+	  mxml_load_error(options, r, "Unable to add declaration node to parent <%s> on line %d.", parent ? parent->value.element.name : "null", line);
+	  goto error;
+	}
+
+	MXML_DEBUG("mxml_load_data: node=%p(<%s>), parent=%p\n", node, buffer, parent);
+
+        if (options && options->sax_cb)
+        {
+          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_DECLARATION))
+	    goto error;
+
+          if (!mxmlRelease(node))
+            node = NULL;
+        }
+
+        if (node)
+	{
+	  if (!first)
+            first = node;
+
+	  if (!parent)
+	  {
+	    parent = node;
+
+	    if (options)
+	      type = mxml_load_type(options, parent);
+	    else
+	      type = MXML_TYPE_TEXT;
+	  }
+	}
+      }
+      else if (buffer[0] == '/')
+      {
+        // Handle close tag...
+	MXML_DEBUG("mxml_load_data: <%s>, parent=%p\n", buffer, parent);
+
+        if (options && options->event_cb)
+        {
+          // Keep reading until we see >...
+          len = (size_t)(bufptr - buffer - 1);
+
+          while (ch != '>' && ch != EOF)
+	    ch = mxml_getc(options, r);
+
+          if (ch == EOF && r->starved)
+            goto starved;
+
+          if (!mxml_load_close(l, buffer + 1))
+          {
+	    mxml_load_error(options, r, "Mismatched close tag <%s> on line %d.", buffer, line);
+	    goto error;
+          }
+
+          if (!(options->event_cb)(options->event_cbdata, MXML_SAX_EVENT_ELEMENT_CLOSE, buffer + 1, len, /*attrs*/NULL))
+            goto error;
+
+          if (l->stream && l->stacklen == 0)
+            goto document;
+
+          bufptr = buffer;
+          continue;
+        }
+
+        if (!parent || strcmp(buffer + 1, parent->value.element.name))
+	{
+	  // Close tag doesn't match tree; print an error for now...
+	  mxml_load_error(options, r, "Mismatched close tag <%s> under parent <%s> on line %d.", buffer, parent ? parent->value.element.name : "(null)", line);
+          goto error;
+	}
+
+        // Keep reading until we see >...
+        while (ch != '>' && ch != EOF)
+	  ch = mxml_getc(options, r);
+
+        if (ch == EOF && r->starved)
+          goto starved;
+
+        close_element:
+
+        node   = parent;
+        parent = parent->parent;
+
+        if (node == l->match)
+        {
+          // Closed the element matching a filter path...
+          l->match = NULL;
+        }
+        else if (!mxml_load_keep(l, options, parent) && !node->child && !options->sax_cb)
+        {
+          // Remove elements that did not contain a match...
+          mxmlDelete(node);
+          node = NULL;
+        }
+
+        if (options && options->sax_cb)
+        {
+          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_ELEMENT_CLOSE))
+	    goto error;
+
+          if (!mxmlRelease(node))
+          {
+            if (first == node)
+	      first = NULL;
+
+	    node = NULL;
+	  }
+        }
+
+        // Ascend into the parent and set the value type as needed...
+	if (options && parent)
+	  type = mxml_load_type(options, parent);
+	else if (options && !options->type_cb)
+	  type = options->type_value;
+
+        if (!mxml_load_keep(l, options, parent))
+          type = MXML_TYPE_IGNORE;	// Skip values outside the filter paths
+
+        if (l->stream && (!parent || parent->type != MXML_TYPE_ELEMENT))
+          goto document;
+      }
+      else
+      {
+        // Handle open tag...
+        if (options && options->event_cb)
+        {
+          mxml_attrs_t	attrs;		// Attributes
+
+          if (l->root && l->stacklen == 0)
+          {
+	    // There can only be one root element!
+	    mxml_load_error(options, r, "<%s> cannot be a second root element on line %d.", buffer, line);
+	    goto error;
+          }
+
+          len = (size_t)(bufptr - buffer);
+
+          if (mxml_isspace(ch))
+          {
+            // Read any attributes after the name...
+            bufptr ++;
+
+            if ((ch = mxml_parse_attrs(options, r, &bufptr, &buffer, &bufsize, &line)) == EOF)
+              goto error;
+
+            if (l->check_attrs && !mxml_check_attrs(options, r, buffer, buffer + len + 1, bufptr, line))
+              goto error;
+          }
+          else if (ch == '/')
+          {
+            if ((ch = mxml_getc(options, r)) != '>')
+            {
+	      mxml_load_error(options, r, "Expected > but got '%c' instead for element <%s/> on line %d.", ch, buffer, line);
+	      goto error;
+            }
+
+            ch = '/';
+          }
+          else if (ch == EOF)
+          {
+	    mxml_load_error(options, r, "Early EOF in element <%s> on line %d.", buffer, line);
+	    goto error;
+          }
+
+          // Report the element and track it until the close tag...
+          attrs.ptr = buffer + len + 1;
+          attrs.end = bufptr;
+
+          if (!(options->event_cb)(options->event_cbdata, MXML_SAX_EVENT_ELEMENT_OPEN, buffer, len, &attrs))
+            goto error;
+
+          l->root = true;
+
+          if (ch == '/')
+          {
+            if (!(options->event_cb)(options->event_cbdata, MXML_SAX_EVENT_ELEMENT_CLOSE, buffer, len, /*attrs*/NULL))
+              goto error;
+
+            if (l->stream && l->stacklen == 0)
+              goto document;
+          }
+          else if (!mxml_load_open(l, options, buffer, len))
+          {
+            goto error;
+          }
+
+          bufptr = buffer;
+          continue;
+        }
+
+        if (!parent && first)
+	{
+	  // There can only be one root element!
+	  mxml_load_error(options, r, "<%s> cannot be a second root node after <%s> on line %d.", buffer, first->value.element.name, line);
+          goto error;
+	}
+
+        if (options && options->num_filters && !l->match)
+        {
+          // Skip elements that cannot contain a match for the filter paths...
+          if ((filter = mxml_load_filter(l, options, parent, buffer)) == _MXML_FILTER_NONE)
+          {
+            l->skip_close = false;
+            goto skip_element;
+          }
+        }
+        else
+        {
+          filter = _MXML_FILTER_MATCH;
+        }
+
+        if (l->share_names)
+        {
+          // Use a shared copy of the element name...
+          _mxml_name_t *name = mxml_load_name(l, buffer);
+					// Shared name
+
+          node = name ? _mxml_new_element(parent, name) : NULL;
+        }
+        else
+        {
+          node = mxmlNewElement(parent, buffer);
+        }
+
+        if (!node)
+	{
+	  // Just print error for now...
+	  mxml_load_error(options, r, "Unable to add element node to parent <%s> on line %d.", parent ? parent->value.element.name : "null", line);
+	  goto error;
+	}
+
+        if (mxml_isspace(ch))
+        {
+	  MXML_DEBUG("mxml_load_data: node=%p(<%s...>), parent=%p\n", node, buffer, parent);
+
+	  if ((ch = mxml_parse_element(options, r, node, &line)) == EOF)
+	  {
+	    if (r->starved)
+	    {
+	      // Read the element again once more data is pushed...
+	      mxmlDelete(node);
+	    }
+
+	    goto error;
+	  }
+        }
+        else if (ch == '/')
+	{
+	  MXML_DEBUG("mxml_load_data: node=%p(<%s/>), parent=%p\n", node, buffer, parent);
+
+	  if ((ch = mxml_getc(options, r)) != '>')
+	  {
+	    mxml_load_error(options, r, "Expected > but got '%c' instead for element <%s/> on line %d.", ch, buffer, line);
+            mxmlDelete(node);
+            node = NULL;
+            goto error;
+	  }
+
+	  ch = '/';
+	}
+
+        if (ch == '/' && filter == _MXML_FILTER_ANCESTOR && !mxml_load_keep(l, options, parent))
+        {
+          // Remove empty elements that did not contain a match...
+          mxmlDelete(node);
+          node   = NULL;
+          bufptr = buffer;
+          continue;
+        }
+
+        if (options && options->sax_cb)
+        {
+          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_ELEMENT_OPEN))
+	    goto error;
+	}
+
+        if (!first)
+	  first = node;
+
+	if (ch == EOF)
+	  break;
+
+        if (ch != '/' && node->skip)
+        {
+          // Skip the contents as requested by the SAX callback and then report
+          // the close of the element...
+          node->skip    = false;
+          parent        = node;
+          l->skip_close = true;
+
+          skip_element:
+
+          if (mxml_skip_element(l, options, r, ch, &line) == EOF)
+          {
+	    mxml_load_error(options, r, "Early EOF in skipped element on line %d.", line);
+	    goto error;
+          }
+
+          if (l->skip_close)
+            goto close_element;
+
+          bufptr = buffer;
+          continue;
+        }
+
+        if (ch != '/' && l->lazy && mxml_load_skip(l, r, node, &line))
+        {
+          // Skipped the contents and close tag, so treat it like an empty
+          // element until the contents are loaded...
+          ch = '/';
+        }
+
+        if (ch != '/')
+	{
+	  // Descend into this node, setting the value type as needed...
+	  parent = node;
+
+	  if (options && parent)
+	    type = mxml_load_type(options, parent);
+	  else if (options && !options->type_cb)
+	    type = options->type_value;
+	  else
+	    type = MXML_TYPE_TEXT;
+
+          if (filter == _MXML_FILTER_MATCH && options && options->num_filters && !l->match)
+            l->match = node;		// Load everything in the matching element
+          else if (!mxml_load_keep(l, options, parent))
+            type = MXML_TYPE_IGNORE;	// Skip values outside the filter paths
+	}
+        else if (options && options->sax_cb)
+        {
+          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_ELEMENT_CLOSE))
+	    goto error;
+
+          if (!mxmlRelease(node))
+          {
+            if (first == node)
+	      first = NULL;
+
+	    node = NULL;
+	  }
+        }
+
+        if (ch == '/' && l->stream && (!parent || parent->type != MXML_TYPE_ELEMENT))
+          goto document;
+      }
+
+      bufptr  = buffer;
+    }
+    else if (ch == '&')
+    {
+      if (r->partial)
+      {
+        // Save the start of the entity in case we run out of pushed data...
+        l->state    = _MXML_LSTATE_ENTITY;
+        l->line     = line;
+        l->buflen   = (size_t)(bufptr - buffer);
+        l->pos      = mxml_read_tell(r);
+        l->encoding = r->encoding;
+      }
+
+      read_entity:
+
+      // Add character entity to current buffer...
+      if ((ch = mxml_get_entity(options, r, mxml_load_parent(l, parent), &line)) == EOF)
+	goto error;
+
+      if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
+	goto error;
+    }
+    else if (type == MXML_TYPE_OPAQUE || type == MXML_TYPE_CUSTOM || !mxml_isspace(ch))
+    {
+      // Add character to current buffer...
+      if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
+	goto error;
+
+      // Copy the rest of the run of plain text in one go...
+      if ((len = mxml_read_text(r, type != MXML_TYPE_OPAQUE && type != MXML_TYPE_CUSTOM)) > 0)
+      {
+        if (!mxml_add_chars(options, r->curptr, len, &bufptr, &buffer, &bufsize))
+          goto error;
+
+        r->curptr += len;
+      }
+    }
+  }
+  while (!l->paused && (ch = mxml_getc(options, r)) != EOF);
+
+  if (l->paused)
+  {
+    // Stop after the current event and continue with the next character...
+    l->state = _MXML_LSTATE_CHAR;
+    goto pause;
+  }
+
+  // Stop at the end of the data or wait for more pushed data...
+  eof:
+
+  if (r->starved)
+    l->state = _MXML_LSTATE_CHAR;
+  else
+    l->state = _MXML_LSTATE_DONE;
+
+  // Save the load data for the next call...
+  save:
+
+  r->starved    = false;
+  l->first      = first;
+  l->parent     = parent;
+  l->type       = type;
+  l->line       = line;
+  l->whitespace = whitespace;
+  l->buffer     = buffer;
+  l->buflen     = (size_t)(bufptr - buffer);
+  l->bufsize    = bufsize;
+
+  return (true);
+
+  // Closed the root element of a document in a stream, so stop and start the
+  // next document on the next call...
+  document:
+
+  l->state   = _MXML_LSTATE_START;
+  bufptr     = buffer;
+  whitespace = false;
+
+  goto save;
+
+  // The event callback asked to stop after the current event...
+  pause:
+
+  l->paused = false;
+
+  goto save;
+
+  // Ran out of pushed data, so rewind to the start of the current tag or
+  // entity...
+  starved:
+
+  if (l->state == _MXML_LSTATE_TAG || l->state == _MXML_LSTATE_ENTITY || l->state == _MXML_LSTATE_SKIP)
+  {
+    r->bufptr   = l->pos;
+    r->curptr   = NULL;
+    r->curend   = NULL;
+    r->encoding = l->encoding;
+    line        = l->line;
+    bufptr      = buffer + l->buflen;
+  }
+  else if (l->state == _MXML_LSTATE_DECLARATION && l->pos)
+  {
+    // Keep the declaration so far and read the entity again...
+    r->bufptr   = l->pos;
+    r->curptr   = NULL;
+    r->curend   = NULL;
+    r->encoding = l->encoding;
+    line        = l->line;
+  }
+
+  goto save;
+
+  // Common error return...
+  error:
+
+  if (r->starved)
+    goto starved;
+
+  if (r->error)
+    _mxml_error(options, "%s", r->error);
+
+  mxmlDelete(first);
+
+  l->buffer = buffer;
+  mxml_load_free(l);
+
+  l->line  = line;
+
+  l->first = NULL;
+  l->state = _MXML_LSTATE_ERROR;
+
+  return (false);
+}
+
+
+//
+// 'mxml_load_reset()' - Reset the load data to start loading a new node tree.
+//
+// The string buffer, line number, and stream mode are kept.
+//
+
+static void
+mxml_load_reset(
+    _mxml_load_t   *l,			// I - Load data
+    mxml_node_t    *top,		// I - Top node
+    mxml_options_t *options)		// I - Options
+{
+  l->state      = _MXML_LSTATE_START;
+  l->top        = top;
+  l->first      = NULL;
+  l->parent     = top;
+  l->whitespace = false;
+  l->buflen     = 0;
+  l->pos        = NULL;
+  l->encoding   = _MXML_ENCODING_UTF8;
+  l->match      = NULL;
+  l->skip_depth = 0;
+  l->skip_close = false;
+  l->stacklen   = 0;
+  l->root       = false;
+  l->paused     = false;
+
+  if (options && options->event_cb)
+    l->type = MXML_TYPE_OPAQUE;		// Report text as it appears
+  else if (options && top)
+    l->type = mxml_load_type(options, top);
+  else if (options && !options->type_cb)
+    l->type = options->type_value;
+  else
+    l->type = MXML_TYPE_IGNORE;
+}
+
+
+//
+// 'mxml_load_skip()' - Skip the contents of an element to load them later.
+//
+// The contents and close tag of the element are recorded in the element's
+// user data pointer, and reading continues after the close tag.  The contents
+// are loaded normally if the close tag cannot be found in the data.
+//
+
+static bool				// O  - `true` if skipped, `false` to load the contents now
+mxml_load_skip(
+    _mxml_load_t *l,			// I  - Load data
+    _mxml_read_t *r,			// I  - Read buffer
+    mxml_node_t  *node,			// I  - Element node
+    int          *line)			// IO - Current line number
+{
+  const unsigned char	*start,		// Start of contents
+			*end,		// End of data
+			*ptr;		// Pointer into data
+  size_t		namelen;	// Length of element name
+  _mxml_lazyrange_t	*range;		// Source range for contents
+
+
+  // Only UTF-8 data can be loaded in place...
+  if (r->encoding != _MXML_ENCODING_UTF8)
+    return (false);
+
+  // Find the matching close tag...
+  start   = mxml_read_tell(r);
+  end     = r->bufend;
+  namelen = strlen(node->value.element.name);
+
+  if ((ptr = mxml_find_close(start, end)) == NULL || (size_t)(end - ptr) < (namelen + 3) || memcmp(ptr + 2, node->value.element.name, namelen))
+    return (false);
+
+  for (ptr += namelen + 2; ptr < end && mxml_isspace(*ptr); ptr ++);
+
+  if (ptr >= end || *ptr != '>')
+    return (false);
+
+  ptr ++;
+
+  // Record the contents and close tag...
+  if ((range = malloc(sizeof(_mxml_lazyrange_t))) == NULL)
+    return (false);
+
+  range->lazy  = l->lazy;
+  range->start = start;
+  range->end   = ptr;
+  range->line  = *line;
+
+  l->lazy->refs ++;
+
+  node->lazy      = true;
+  node->user_data = range;
+
+  // Count the lines that were skipped and continue after the close tag...
+  while ((start = memchr(start, '\n', (size_t)(ptr - start))) != NULL)
+  {
+    (*line) ++;
+    start ++;
+  }
+
+  if (r->curptr && ptr <= r->curend)
+  {
+    // Still in the validated UTF-8 data...
+    r->curptr = (unsigned char *)ptr;
+  }
+  else
+  {
+    r->bufptr = (unsigned char *)ptr;
+    r->curptr = NULL;
+    r->curend = NULL;
+  }
+
+  return (true);
+}
+
+
+//
+// 'mxml_load_type()' - Get the value type for the children of an element.
+//
+// Element names in the type table are found using a hash lookup, and the type
+// callback is only used for other names.
+//
+
+static mxml_type_t			// O - Value type
+mxml_load_type(
+    mxml_options_t *options,		// I - Options
+    mxml_node_t    *node)		// I - Parent node
+{
+  _mxml_types_t	*types = options->types;// Value types for element names
+  size_t	h;			// Current slot
+
+
+  if (types && node->type == MXML_TYPE_ELEMENT)
+  {
+    // Look for the element name, probing linearly from the hashed slot...
+    for (h = mxml_hash_string(node->value.element.name) & (types->size - 1); types->names[h]; h = (h + 1) & (types->size - 1))
+    {
+      if (!strcmp(types->names[h], node->value.element.name))
+        return (types->types[h]);
+    }
+  }
+
+  if (options->type_cb)
+    return ((options->type_cb)(options->type_cbdata, node));
+  else
+    return (options->type_value);
+}
+
+
+//
+// 'mxml_load_io()' - Load data into an XML node tree using a read callback.
+//
+
+static mxml_node_t *			// O - First node or `NULL` if the XML could not be read.
+mxml_load_io(
+    mxml_node_t     *top,		// I - Top node
+    mxml_options_t  *options,		// I - Options
+    mxml_io_cb_t    io_cb,		// I - Read callback function
+    void            *io_cbdata)		// I - Read callback data
+{
+  _mxml_read_t	r;			// Read buffer
+  mxml_node_t	*ret;			// First node
+
+
+  // Setup the read buffer...
+  if (!mxml_read_open(&r, options, io_cb, io_cbdata, NULL, 0))
+    return (NULL);
+
+  // Read the XML data...
+  ret = mxml_load_data(top, options, &r, /*lazy*/NULL);
+
+  mxml_read_free(&r);
+
+  return (ret);
+}
+
+
+//
+// 'mxml_load_keep()' - Determine whether to keep a node that is not an element.
+//
+// When filtering, only the nodes in matching elements and outside the root
+// element are kept.
+//
+
+static bool				// O - `true` to keep the node, `false` to skip it
+mxml_load_keep(_mxml_load_t   *l,	// I - Load data
+               mxml_options_t *options,	// I - Options
+               mxml_node_t    *parent)	// I - Parent node
+{
+  return (!options || !options->num_filters || l->match || !parent || parent == l->top || parent->type != MXML_TYPE_ELEMENT);
+}
+
+
+//
+// 'mxml_load_memory()' - Load data into an XML node tree from memory.
+//
+// The data is parsed in place without copying it into a read buffer.  When
+// loading element contents later, the source data must stay valid until the
+// loaded nodes are deleted, so a mapped file is unmapped once the last element
+// that uses it is loaded or deleted.
+//
+
+static mxml_node_t *			// O - First node or `NULL` if the XML could not be read.
+mxml_load_memory(
+    mxml_node_t     *top,		// I - Top node
+    mxml_options_t  *options,		// I - Options
+    const void      *data,		// I - Data
+    size_t          datalen,		// I - Length of data
+    bool            mapped)		// I - Is the data a mapped file?
+{
+  _mxml_read_t	r;			// Read buffer
+  _mxml_lazy_t	*lazy = NULL;		// Source data for loading element contents later
+  mxml_node_t	*ret = NULL;		// First node
+#ifdef HAVE_PTHREAD_H
+  const unsigned char *rootend;		// End of root element's open tag
+
+
+  // Load large documents using multiple threads, if enabled...
+  if (options && options->threads != 1 && !options->lazy && !options->num_filters && !options->sax_cb && !options->event_cb && options->compression != MXML_COMPRESSION_GZIP && datalen >= (2 * MXML_CHUNK_SIZE) && (rootend = mxml_scan_root(data, datalen)) != NULL)
+    ret = mxml_load_parallel(top, options, data, datalen, rootend);
+  else
+#endif // HAVE_PTHREAD_H
+
+  // Setup the read buffer to point at the data...
+  if (mxml_read_open(&r, options, /*io_cb*/NULL, /*io_cbdata*/NULL, data, datalen))
+  {
+    if (options && options->lazy && !options->num_filters && !options->sax_cb && !options->event_cb && r.buffer == data && (lazy = calloc(1, sizeof(_mxml_lazy_t))) != NULL)
+    {
+      // Load element contents when they are first accessed, reading the
+      // uncompressed data in place...
+      lazy->refs                = 1;
+      lazy->options             = *options;
+      lazy->options.compression = MXML_COMPRESSION_NONE;
+
+      if (lazy->options.types)
+        _mxml_types_retain(lazy->options.types);
+
+      if (mapped)
+      {
+        lazy->map    = (void *)data;
+        lazy->maplen = datalen;
+        mapped       = false;
+      }
+    }
+
+    // Read the XML data...
+    ret = mxml_load_data(top, options, &r, lazy);
+
+    mxml_read_free(&r);
+    mxml_lazy_release(lazy);
+  }
+
+#ifdef HAVE_SYS_MMAN_H
+  // Unmap the file if no element contents are loaded from it later...
+  if (mapped)
+    munmap((void *)data, datalen);
+#endif // HAVE_SYS_MMAN_H
+
+  return (ret);
+}
+
+
+//
+// 'mxml_load_name()' - Find or add a shared element name.
+//
+// Each distinct element name is stored once per load, and element nodes with
+// the same name share it.  The load data holds a reference to each name until
+// @code mxml_load_free@ is called.
+//
+
+static _mxml_name_t *			// O - Shared name or `NULL` on error
+mxml_load_name(_mxml_load_t *l,		// I - Load data
+               const char   *s)		// I - Name string
+{
+  size_t	h,			// Hash of name
+		i;			// Looping var
+  _mxml_name_t	**names,		// New hash table
+		*name;			// Current name
+
+
+  // Grow the hash table as needed to keep it at most half full...
+  if ((l->num_names + 1) * 2 > l->alloc_names)
+  {
+    size_t alloc_names = l->alloc_names ? 2 * l->alloc_names : 64;
+					// New size of table
+
+    if ((names = calloc(alloc_names, sizeof(_mxml_name_t *))) == NULL)
+      return (NULL);
+
+    for (i = 0; i < l->alloc_names; i ++)
+    {
+      if ((name = l->names[i]) != NULL)
+      {
+        for (h = mxml_hash_string(name->name) & (alloc_names - 1); names[h]; h = (h + 1) & (alloc_names - 1));
+
+        names[h] = name;
+      }
+    }
+
+    free(l->names);
+
+    l->alloc_names = alloc_names;
+    l->names       = names;
+  }
+
+  // Look for the name, probing linearly from the hashed slot...
+  for (h = mxml_hash_string(s) & (l->alloc_names - 1); (name = l->names[h]) != NULL; h = (h + 1) & (l->alloc_names - 1))
+  {
+    if (!strcmp(name->name, s))
+      return (name);
+  }
+
+  // Add a new name...
+  if ((name = _mxml_name_new(s)) != NULL)
+  {
+    l->names[h] = name;
+    l->num_names ++;
+  }
+
+  return (name);
+}
+
+
+//
+// 'mxml_load_open()' - Open an element reported to the event callback.
+//
+// The name is added to the element stack so the close tag can be checked.  The
+// stack only grows, so no memory is allocated once it can hold the deepest
+// element names.
+//
+
+static bool				// O - `true` on success, `false` on error
+mxml_load_open(_mxml_load_t   *l,	// I - Load data
+               mxml_options_t *options,	// I - Options
+               const char     *name,	// I - Element name
+               size_t         namelen)	// I - Length of name
+{
+  if (l->stacklen + namelen + 1 > l->stacksize)
+  {
+    size_t	stacksize = 2 * (l->stacklen + namelen + 1) + 256;
+					// New size of stack
+    char	*stack;			// New stack
+
+    if ((stack = realloc(l->stack, stacksize)) == NULL)
+    {
+      _mxml_error(options, "Unable to allocate memory for element <%s>.", name);
+      return (false);
+    }
+
+    l->stack     = stack;
+    l->stacksize = stacksize;
+  }
+
+  memcpy(l->stack + l->stacklen, name, namelen + 1);
+  l->stacklen += namelen + 1;
+
+  return (true);
+}
+
+
+
+//
+// 'mxml_load_parent()' - Get the name of the current parent element.
+//
+// The event callback path does not create nodes, so the name of the last open
+// element is used instead of the parent node.
+//
+
+static const char *			// O - Element name
+mxml_load_parent(_mxml_load_t *l,	// I - Load data
+                 mxml_node_t  *parent)	// I - Parent node or `NULL`
+{
+  const char	*top;			// Last open element name
+
+
+  if (parent)
+    return (parent->value.element.name);
+  else if (l->stacklen == 0)
+    return ("null");
+
+  for (top = l->stack + l->stacklen - 1; top > l->stack && top[-1]; top --);
+
+  return (top);
+}
+
+#ifdef HAVE_PTHREAD_H
+//
+// 'mxml_load_parallel()' - Load data into an XML node tree using multiple threads.
+//
+// The data up to the end of the root element's open tag is loaded by a push
+// parser.  The children of the root element are then split into chunks that
+// are loaded by worker threads and moved to the root element in order, up to
+// the first chunk that could not be loaded completely.  The push parser loads
+// the rest of the data, so the nodes and any errors are the same as for
+// loading the data using a single thread.
+//
+
+static mxml_node_t *			// O - First node or `NULL` if the XML could not be read.
+mxml_load_parallel(
+    mxml_node_t         *top,		// I - Top node
+    mxml_options_t      *options,	// I - Options
+    const unsigned char *data,		// I - Data
+    size_t              datalen,	// I - Length of data
+    const unsigned char *rootend)	// I - End of root element's open tag
+{
+  mxml_parser_t	*parser;		// Push parser
+  mxml_node_t	*root,			// Root element
+		*container,		// Container for chunk
+		*node,			// Current node
+		*ret;			// First node
+  const unsigned char *ptr = rootend,	// Where to continue loading
+		*end = data + datalen,	// End of data
+		*children,		// End of children of root element
+		*child,			// First child element
+		*split;			// Split between chunks
+  const char	*name;			// Name of root element
+  size_t	i, j,			// Looping vars
+		namelen,		// Length of root element name
+		childlen,		// Length of child element name
+		count,			// Number of chunks
+		nthreads,		// Number of threads
+		num_threads = 0;	// Number of worker threads
+  int		lines = 0;		// Number of lines in loaded chunks
+  _mxml_chunks_t chunks;		// Chunks to load
+  _mxml_chunk_t	*chunk;			// Current chunk
+  _mxml_global_t *global;		// Global data
+  pthread_t	*threads;		// Worker threads
+
+
+  // Load up to the end of the root element's open tag...
+  if ((parser = mxmlParserNew(top, options)) == NULL)
+    return (NULL);
+
+  if (!mxmlParserFeed(parser, data, (size_t)(rootend - data)))
+  {
+    mxmlParserDelete(parser);
+    return (NULL);
+  }
+
+  if ((nthreads = options->threads) == 0)
+    nthreads = mxml_cpu_count();
+
+  root = parser->l.parent;
+
+  if (nthreads < 2 || parser->l.state != _MXML_LSTATE_CHAR || !root || root == parser->l.top || root->type != MXML_TYPE_ELEMENT || parser->l.buflen > 0 || parser->l.whitespace || parser->r.bufptr < parser->r.bufend)
+    goto finish;
+
+  // Find the end of the last child node before the root element's close tag...
+  name    = root->value.element.name;
+  namelen = strlen(name);
+
+  for (children = end - 2; children > rootend; children --)
+  {
+    if (children[0] == '<' && children[1] == '/')
+      break;
+  }
+
+  if ((size_t)(end - children) <= (namelen + 2) || memcmp(children + 2, name, namelen) || (children[namelen + 2] != '>' && !mxml_isspace(children[namelen + 2])))
+    goto finish;
+
+  while (children > rootend && children[-1] != '>')
+    children --;
+
+  // Find the first child element, whose name is used to split the chunks...
+  for (child = rootend; (child = memchr(child, '<', (size_t)(children - child))) != NULL; child ++)
+  {
+    if (child[1] != '!' && child[1] != '?' && child[1] != '/')
+      break;
+  }
+
+  if (!child)
+    goto finish;
+
+  for (childlen = 0, child ++; child + childlen < children && (mxml_char_class(child[childlen]) & _MXML_CHAR_TAG); childlen ++);
+
+  if ((count = (size_t)(children - rootend) / MXML_CHUNK_SIZE) > (4 * nthreads))
+    count = 4 * nthreads;
+
+  if (childlen == 0 || count < 2 || (chunks.chunks = calloc(count, sizeof(_mxml_chunk_t))) == NULL)
+    goto finish;
+
+  // Split the children into chunks...
+  chunks.chunks[0].start = rootend;
+
+  for (i = 1; i < count; i ++)
+  {
+    split = rootend + i * ((size_t)(children - rootend) / count);
+
+    if (split < chunks.chunks[i - 1].start)
+      split = chunks.chunks[i - 1].start;
+
+    if ((split = mxml_find_split(split, children, child, childlen)) == NULL)
+      break;
+
+    chunks.chunks[i - 1].end = split;
+    chunks.chunks[i].start   = split;
+  }
+
+  chunks.chunks[i - 1].end = children;
+  chunks.count             = i;
+
+  // Create a copy of the root element for each chunk, and report errors to
+  // the chunk.  The copy has a parent of its own so that a close tag for the
+  // root element cannot leave nodes without a parent...
+  for (i = chunks.count, chunk = chunks.chunks; i > 0; i --, chunk ++)
+  {
+    chunk->options              = *options;
+    chunk->options.compression  = MXML_COMPRESSION_NONE;
+    chunk->options.error_cb     = (mxml_error_cb_t)mxml_load_chunk_error;
+    chunk->options.error_cbdata = chunk;
+
+    if ((node = mxmlNewElement(/*parent*/NULL, name)) != NULL && (chunk->container = mxmlNewElement(node, name)) == NULL)
+      mxmlDelete(node);
+
+    if (chunk->container)
+    {
+      for (j = 0; j < root->value.element.num_attrs; j ++)
+        mxmlElementSetAttr(chunk->container, root->value.element.attrs[j].name, root->value.element.attrs[j].value);
+    }
+  }
+
+  // Load the chunks using worker threads to help this thread...
+  global = _mxml_global();
+
+  chunks.next       = 0;
+  chunks.strcopy_cb = global->strcopy_cb;
+  chunks.strfree_cb = global->strfree_cb;
+  chunks.str_cbdata = global->str_cbdata;
+
+  if (nthreads > chunks.count)
+    nthreads = chunks.count;
+
+  pthread_mutex_init(&chunks.mutex, NULL);
+
+  if ((threads = calloc(nthreads - 1, sizeof(pthread_t))) != NULL)
+  {
+    for (; num_threads < (nthreads - 1); num_threads ++)
+    {
+      if (pthread_create(threads + num_threads, NULL, (void *(*)(void *))mxml_load_chunks, &chunks))
+        break;
+    }
+  }
+
+  mxml_load_chunks(&chunks);
+
+  for (i = 0; i < num_threads; i ++)
+    pthread_join(threads[i], NULL);
+
+  free(threads);
+
+  pthread_mutex_destroy(&chunks.mutex);
+
+  // Move the nodes from each chunk that was loaded completely to the root
+  // element...
+  for (i = chunks.count, chunk = chunks.chunks; i > 0 && chunk->loaded; i --, chunk ++)
+  {
+    container = chunk->container;
+
+    if (container->child)
+    {
+      for (node = container->child; node; node = node->next)
+        node->parent = root;
+
+      if (root->last_child)
+      {
+        root->last_child->next = container->child;
+        container->child->prev = root->last_child;
+      }
+      else
+      {
+        root->child = container->child;
+      }
+
+      root->last_child      = container->last_child;
+      container->child      = NULL;
+      container->last_child = NULL;
+    }
+
+    lines += chunk->lines;
+    ptr   = chunk->end;
+  }
+
+  for (i = chunks.count, chunk = chunks.chunks; i > 0; i --, chunk ++)
+  {
+    if (chunk->container)
+      mxmlDelete(chunk->container->parent);
+  }
+
+  free(chunks.chunks);
+
+  parser->l.line += lines;
+
+  // Load the rest of the data...
+  finish:
+
+  if (mxmlParserFeed(parser, ptr, (size_t)(end - ptr)))
+    ret = mxmlParserFinish(parser);
+  else
+    ret = NULL;
+
+  mxmlParserDelete(parser);
+
+  return (ret);
+}
+#endif // HAVE_PTHREAD_H
+
+
+//
+// 'mxml_match_path()' - Match element names against a filter path.
+//
+// The names start with the root element.  A "*/" prefix matches any number of
+// elements before the next name in the path.
+//
+
+static _mxml_filter_t			// O - Best match for the last name
+mxml_match_path(
+    const char         *path,		// I - Remaining path
+    const char * const *names,		// I - Remaining element names
+    size_t             count)		// I - Number of names
+{
+  const char	*sep,			// Separator after name in path
+		*next;			// Next name in path
+  size_t	len;			// Length of name in path
+  bool		any = false;		// Match any number of elements first?
+  _mxml_filter_t match = _MXML_FILTER_NONE,
+					// Match for this name
+		skip;			// Match for a later name
+
+
+  if (!*path)
+    return (_MXML_FILTER_MATCH);
+  else if (count == 0)
+    return (_MXML_FILTER_ANCESTOR);
+
+  if (!strncmp(path, "*/", 2))
+  {
+    any  = true;
+    path += 2;
+  }
+
+  if ((sep = strchr(path, '/')) == NULL)
+    sep = path + strlen(path);
+
+  len  = (size_t)(sep - path);
+  next = *sep ? sep + 1 : sep;
+
+  if (!strncmp(names[0], path, len) && !names[0][len])
+    match = mxml_match_path(next, names + 1, count - 1);
+
+  if (any && match != _MXML_FILTER_MATCH && (skip = mxml_match_path(path - 2, names + 1, count - 1)) > match)
+    match = skip;
+
+  return (match);
+}
+
+
+//
+// 'mxml_mul128()' - Multiply two 64-bit integers to get a 128-bit product.
+//
+
+static uint64_t				// O - Lower 64 bits of product
+mxml_mul128(uint64_t a,			// I - First number
+            uint64_t b,			// I - Second number
+            uint64_t *hi)		// O - Upper 64 bits of product
+{
+#ifdef __SIZEOF_INT128__
+  unsigned __int128	product = (unsigned __int128)a * b;
+					// Product
+
+
+  *hi = (uint64_t)(product >> 64);
+
+  return ((uint64_t)product);
+
+#else
+  uint64_t	alo = a & 0xffffffff,	// Lower 32 bits of a
+		ahi = a >> 32,		// Upper 32 bits of a
+		blo = b & 0xffffffff,	// Lower 32 bits of b
+		bhi = b >> 32,		// Upper 32 bits of b
+		lolo = alo * blo,	// Partial products
+		lohi = alo * bhi,
+		hilo = ahi * blo,
+		mid;			// Middle 32 bits plus carry
+
+
+  mid = (lolo >> 32) + (lohi & 0xffffffff) + (hilo & 0xffffffff);
+  *hi = ahi * bhi + (lohi >> 32) + (hilo >> 32) + (mid >> 32);
+
+  return ((mid << 32) | (lolo & 0xffffffff));
+#endif // __SIZEOF_INT128__
+}
+
+
+//
+// 'mxml_parse_attrs()' - Parse the attributes of an element for the event callback.
+//
+// The attribute names and values are added to the string buffer after the
+// element name as pairs of nul-terminated strings.
+//
+
+static int				// O  - Terminating character or `EOF` on error
+mxml_parse_attrs(
+    mxml_options_t *options,		// I  - Options
+    _mxml_read_t   *r,			// I  - Read buffer
+    char           **bufptr,		// IO - Current position in buffer
+    char           **buffer,		// IO - Current buffer
+    size_t         *bufsize,		// IO - Current buffer size
+    int            *line)		// IO - Current line number
+{
+  int		ch,			// Current character in file
+		quote;			// Quoting character
+  size_t	name,			// Offset of attribute name in buffer
+		len;			// Length of value run
+
+
+  // Loop until we hit a >, /, ?, or EOF...
+  while ((ch = mxml_getc(options, r)) != EOF)
+  {
+    // Skip leading whitespace...
+    if (mxml_isspace(ch))
+    {
+      if (ch == '\n')
+        (*line)++;
+
+      continue;
+    }
+
+    // Stop at /, ?, or >...
+    if (ch == '/' || ch == '?')
+    {
+      // Grab the > character and print an error if it isn't there...
+      if ((quote = mxml_getc(options, r)) != '>')
+      {
+        mxml_load_error(options, r, "Expected '>' after '%c' for element %s, but got '%c' on line %d.", ch, *buffer, quote, *line);
+        return (EOF);
+      }
+
+      return (ch);
+    }
+    else if (ch == '<')
+    {
+      mxml_load_error(options, r, "Bare < in element %s on line %d.", *buffer, *line);
+      return (EOF);
+    }
+    else if (ch == '>')
+    {
+      return (ch);
+    }
+
+    // Read the attribute name...
+    name = (size_t)(*bufptr - *buffer);
+
+    if (!mxml_add_char(options, ch, bufptr, buffer, bufsize))
+      return (EOF);
+
+    if (ch == '\"' || ch == '\'')
+    {
+      // Name is in quotes, so get a quoted string...
+      quote = ch;
+
+      while ((ch = mxml_getc(options, r)) != EOF)
+      {
+        if (ch == '&')
+        {
+	  if ((ch = mxml_get_entity(options, r, *buffer, line)) == EOF)
+	    return (EOF);
+	}
+	else if (ch == '\n')
+	{
+	  (*line)++;
+	}
+
+	if (!mxml_add_char(options, ch, bufptr, buffer, bufsize))
+	  return (EOF);
+
+	if (ch == quote)
+          break;
+      }
+    }
+    else
+    {
+      // Grab an normal, non-quoted name...
+      if (!mxml_read_span(options, r, _MXML_CHAR_NAME, bufptr, buffer, bufsize))
+        return (EOF);
+
+      while ((ch = mxml_getc(options, r)) != EOF)
+      {
+	if (mxml_char_class(ch) & _MXML_CHAR_NAME_END)
+	{
+	  if (ch == '\n')
+	    (*line)++;
+          break;
+        }
+	else
+	{
+          if (ch == '&')
+          {
+	    if ((ch = mxml_get_entity(options, r, *buffer, line)) == EOF)
+	      return (EOF);
+          }
+
+	  if (!mxml_add_char(options, ch, bufptr, buffer, bufsize) || !mxml_read_span(options, r, _MXML_CHAR_NAME, bufptr, buffer, bufsize))
+	    return (EOF);
+	}
+      }
+    }
+
+    if (!mxml_add_char(options, '\0', bufptr, buffer, bufsize))
+      return (EOF);
+
+    while (ch != EOF && mxml_isspace(ch))
+    {
+      ch = mxml_getc(options, r);
+
+      if (ch == '\n')
+        (*line)++;
+    }
+
+    if (ch == '=')
+    {
+      // Read the attribute value...
+      while ((ch = mxml_getc(options, r)) != EOF && mxml_isspace(ch))
+      {
+        if (ch == '\n')
+          (*line)++;
+      }
+    }
+    else
+    {
+      ch = EOF;
+    }
+
+    if (ch == EOF)
+    {
+      mxml_load_error(options, r, "Missing value for attribute '%s' in element %s on line %d.", *buffer + name, *buffer, *line);
+      return (EOF);
+    }
+
+    if (ch == '\'' || ch == '\"')
+    {
+      // Read quoted value...
+      quote = ch;
+
+      while ((ch = mxml_getc(options, r)) != EOF && ch != quote)
+      {
+	if (ch == '&')
+	{
+	  if ((ch = mxml_get_entity(options, r, *buffer, line)) == EOF)
+	    return (EOF);
+	}
+	else if (ch == '\n')
+	{
+	  (*line)++;
+	}
+
+	if (!mxml_add_char(options, ch, bufptr, buffer, bufsize))
+	  return (EOF);
+
+	// Copy the rest of the value up to the next quote or entity...
+	if ((len = mxml_read_quoted(r, quote, line)) > 0)
+	{
+	  if (!mxml_add_chars(options, r->curptr, len, bufptr, buffer, bufsize))
+	    return (EOF);
+
+	  r->curptr += len;
+	}
+      }
+    }
+    else
+    {
+      // Read unquoted value...
+      if (!mxml_add_char(options, ch, bufptr, buffer, bufsize) || !mxml_read_span(options, r, _MXML_CHAR_VALUE, bufptr, buffer, bufsize))
+	return (EOF);
+
+      while ((ch = mxml_getc(options, r)) != EOF)
+      {
+	if (mxml_char_class(ch) & _MXML_CHAR_VALUE_END)
+	{
+	  if (ch == '\n')
+	    (*line)++;
+
+	  break;
+	}
+	else
+	{
+	  if (ch == '&')
+	  {
+	    if ((ch = mxml_get_entity(options, r, *buffer, line)) == EOF)
+	      return (EOF);
+	  }
+
+	  if (!mxml_add_char(options, ch, bufptr, buffer, bufsize) || !mxml_read_span(options, r, _MXML_CHAR_VALUE, bufptr, buffer, bufsize))
+	    return (EOF);
+	}
+      }
+    }
+
+    if (ch == EOF || !mxml_add_char(options, '\0', bufptr, buffer, bufsize))
+      return (EOF);
+
+    // Check the end character...
+    if (ch == '/' || ch == '?')
+    {
+      // Grab the > character and print an error if it isn't there...
+      if ((quote = mxml_getc(options, r)) != '>')
+      {
+        mxml_load_error(options, r, "Expected '>' after '%c' for element %s, but got '%c' on line %d.", ch, *buffer, quote, *line);
+        return (EOF);
+      }
+
+      return (ch);
+    }
+    else if (ch == '>')
+    {
+      return (ch);
+    }
+  }
+
+  return (EOF);
+}
+
+
+//
+// 'mxml_parse_element()' - Parse an element for any attributes...
+//
+
+static int				// O  - Terminating character
+mxml_parse_element(
+    mxml_options_t   *options,		// I  - Options
+    _mxml_read_t     *r,		// I  - Read buffer
+    mxml_node_t      *node,		// I  - Element node
+    int              *line)		// IO - Current line number
+{
+  int		ch,			// Current character in file
+		quote;			// Quoting character
+  char		*name,			// Attribute name
+		*value,			// Attribute value
+		*ptr;			// Pointer into name/value
+  size_t	namesize,		// Size of name string
+		valsize,		// Size of value string
+		len,			// Length of value run
+		*slot;			// Hash slot for name
+  _mxml_attrhash_t hash;		// Attribute name hash table
+
+
+  // Initialize the name and value buffers...
+  if ((name = malloc(64)) == NULL)
+  {
+    mxml_load_error(options, r, "Unable to allocate memory for name.");
+    return (EOF);
+  }
+
+  namesize = 64;
+
+  if ((value = malloc(64)) == NULL)
+  {
+    free(name);
+    mxml_load_error(options, r, "Unable to allocate memory for value.");
+    return (EOF);
+  }
+
+  valsize = 64;
+
+  hash.size  = 0;
+  hash.slots = NULL;
+
+  // Loop until we hit a >, /, ?, or EOF...
+  while ((ch = mxml_getc(options, r)) != EOF)
+  {
+    MXML_DEBUG("mxml_parse_element: ch='%c'\n", ch);
+
+    // Skip leading whitespace...
+    if (mxml_isspace(ch))
+    {
+      if (ch == '\n')
+        (*line)++;
+
+      continue;
+    }
+
+    // Stop at /, ?, or >...
+    if (ch == '/' || ch == '?')
+    {
+      // Grab the > character and print an error if it isn't there...
+      quote = mxml_getc(options, r);
+
+      if (quote != '>')
+      {
+        mxml_load_error(options, r, "Expected '>' after '%c' for element %s, but got '%c' on line %d.", ch, mxmlGetElement(node), quote, *line);
+        goto error;
+      }
+
+      break;
+    }
+    else if (ch == '<')
+    {
+      mxml_load_error(options, r, "Bare < in element %s on line %d.", mxmlGetElement(node), *line);
+      goto error;
+    }
+    else if (ch == '>')
+    {
+      break;
+    }
+
+    // Read the attribute name...
+    ptr = name;
+    if (!mxml_add_char(options, ch, &ptr, &name, &namesize))
+      goto error;
+
+    if (ch == '\"' || ch == '\'')
+    {
+      // Name is in quotes, so get a quoted string...
+      quote = ch;
+
+      while ((ch = mxml_getc(options, r)) != EOF)
+      {
+        if (ch == '&')
+        {
+	  if ((ch = mxml_get_entity(options, r, node->value.element.name, line)) == EOF)
+	    goto error;
+	}
+	else if (ch == '\n')
+	{
+	  (*line)++;
+	}
+
+	if (!mxml_add_char(options, ch, &ptr, &name, &namesize))
+	  goto error;
+
+	if (ch == quote)
+          break;
+      }
+    }
+    else
+    {
+      // Grab an normal, non-quoted name...
+      if (!mxml_read_span(options, r, _MXML_CHAR_NAME, &ptr, &name, &namesize))
+        goto error;
+
+      while ((ch = mxml_getc(options, r)) != EOF)
+      {
+	if (mxml_char_class(ch) & _MXML_CHAR_NAME_END)
+	{
+	  if (ch == '\n')
+	    (*line)++;
+          break;
+        }
+	else
+	{
+          if (ch == '&')
+          {
+	    if ((ch = mxml_get_entity(options, r, node->value.element.name, line)) == EOF)
+	      goto error;
+          }
+
+	  if (!mxml_add_char(options, ch, &ptr, &name, &namesize) || !mxml_read_span(options, r, _MXML_CHAR_NAME, &ptr, &name, &namesize))
+	    goto error;
+	}
+      }
+    }
+
+    *ptr = '\0';
+
+    if (node->value.element.num_attrs < MXML_ATTR_HASH)
+    {
+      // Look for a duplicate attribute in the list...
+      slot = NULL;
+
+      if (mxmlElementGetAttr(node, name))
+      {
+	mxml_load_error(options, r, "Duplicate attribute '%s' in element %s on line %d.", name, mxmlGetElement(node), *line);
+	goto error;
+      }
+    }
+    else
+    {
+      // Look for a duplicate attribute in the hash table, growing it as
+      // needed...
+      if ((node->value.element.num_attrs + 1) * 2 > hash.size && !mxml_hash_attrs(&hash, node))
+      {
+        mxml_load_error(options, r, "Unable to allocate memory for attributes.");
+        goto error;
+      }
+
+      if (*(slot = mxml_hash_attr(&hash, node, name)))
+      {
+	mxml_load_error(options, r, "Duplicate attribute '%s' in element %s on line %d.", name, mxmlGetElement(node), *line);
+	goto error;
+      }
+    }
+
+    while (ch != EOF && mxml_isspace(ch))
+    {
+      ch = mxml_getc(options, r);
+
+      if (ch == '\n')
+        (*line)++;
+    }
+
+    if (ch == '=')
+    {
+      // Read the attribute value...
+      while ((ch = mxml_getc(options, r)) != EOF && mxml_isspace(ch))
+      {
+        if (ch == '\n')
+          (*line)++;
+      }
+
+      if (ch == EOF)
+      {
+        mxml_load_error(options, r, "Missing value for attribute '%s' in element %s on line %d.", name, mxmlGetElement(node), *line);
+        goto error;
+      }
+
+      if (ch == '\'' || ch == '\"')
+      {
+        // Read quoted value...
+        quote = ch;
+	ptr   = value;
+
+        while ((ch = mxml_getc(options, r)) != EOF)
+        {
+	  if (ch == quote)
+	  {
 	    break;
+	  }
+	  else
+	  {
+	    if (ch == '&')
+	    {
+	      if ((ch = mxml_get_entity(options, r, node->value.element.name, line)) == EOF)
+	        goto error;
+	    }
+	    else if (ch == '\n')
+	    {
+	      (*line)++;
+	    }
+
+	    if (!mxml_add_char(options, ch, &ptr, &value, &valsize))
+	      goto error;
+
+	    // Copy the rest of the value up to the next quote or entity...
+	    if ((len = mxml_read_quoted(r, quote, line)) > 0)
+	    {
+	      if (!mxml_add_chars(options, r->curptr, len, &ptr, &value, &valsize))
+	        goto error;
+
+	      r->curptr += len;
+	    }
+	  }
+	}
+
+        *ptr = '\0';
+      }
+      else
+      {
+        // Read unquoted value...
+	ptr      = value;
+	if (!mxml_add_char(options, ch, &ptr, &value, &valsize) || !mxml_read_span(options, r, _MXML_CHAR_VALUE, &ptr, &value, &valsize))
+	  goto error;
+
+	while ((ch = mxml_getc(options, r)) != EOF)
+	{
+	  if (mxml_char_class(ch) & _MXML_CHAR_VALUE_END)
+	  {
+	    if (ch == '\n')
+	      (*line)++;
+
+            break;
+          }
+	  else
+	  {
+	    if (ch == '&')
+	    {
+	      if ((ch = mxml_get_entity(options, r, node->value.element.name, line)) == EOF)
+	        goto error;
+	    }
+
+	    if (!mxml_add_char(options, ch, &ptr, &value, &valsize) || !mxml_read_span(options, r, _MXML_CHAR_VALUE, &ptr, &value, &valsize))
+	      goto error;
+	  }
+	}
+
+        *ptr = '\0';
+      }
+
+      // Add the attribute with the given string value...
+      if (!_mxml_add_attr(node, name, value))
+      {
+        mxml_load_error(options, r, "Unable to allocate memory for attribute '%s'.", name);
+        goto error;
+      }
+
+      if (slot)
+        *slot = node->value.element.num_attrs;
+
+      MXML_DEBUG("mxml_parse_element: %s=\"%s\"\n", name, value);
+    }
+    else
+    {
+      mxml_load_error(options, r, "Missing value for attribute '%s' in element %s on line %d.", name, mxmlGetElement(node), *line);
+      goto error;
+    }
+
+    // Check the end character...
+    if (ch == '/' || ch == '?')
+    {
+      // Grab the > character and print an error if it isn't there...
+      quote = mxml_getc(options, r);
+
+      if (quote != '>')
+      {
+        mxml_load_error(options, r, "Expected '>' after '%c' for element %s, but got '%c' on line %d.", ch, mxmlGetElement(node), quote, *line);
+        ch = EOF;
+      }
+
+      break;
+    }
+    else if (ch == '>')
+      break;
+  }
+
+  // Free the name and value buffers and return...
+  free(name);
+  free(value);
+  free(hash.slots);
+
+  return (ch);
+
+  // Common error return point...
+  error:
+
+  free(name);
+  free(value);
+  free(hash.slots);
+
+  return (EOF);
+}
+
+
+//
+// 'mxml_parser_reserve()' - Make room for unread data in a push parser.
+//
+// On error the nodes that have been loaded are deleted and the push parser
+// stops parsing.
+//
+
+static bool				// O - `true` on success, `false` on error
+mxml_parser_reserve(
+    mxml_parser_t *parser,		// I - Push parser
+    size_t        bytes)		// I - Number of bytes needed
+{
+  unsigned char	*data;			// New data buffer
+  size_t	datasize;		// New size of data buffer
+
+
+  if (bytes <= parser->datasize)
+    return (true);
+
+  if ((datasize = 2 * parser->datasize) < bytes)
+    datasize = bytes;
+
+  if ((data = realloc(parser->data, datasize)) == NULL)
+  {
+    _mxml_error(parser->options, "Unable to allocate %lu bytes for pushed data.", (unsigned long)datasize);
+
+    mxmlDelete(parser->l.first);
+    mxml_load_free(&parser->l);
+
+    parser->l.first = NULL;
+    parser->l.state = _MXML_LSTATE_ERROR;
+
+    return (false);
+  }
+
+  parser->data     = data;
+  parser->datasize = datasize;
+
+  return (true);
+}
+
+
+#ifdef HAVE_PTHREAD_H
+//
+// 'mxml_read_ahead_ok()' - Check whether a source can be read by a read-ahead thread.
+//
+// A `FILE` pointer is only read ahead when it is a regular file since a
+// blocked `fread` cannot be interrupted when loading stops early.
+//
+
+static bool				// O - `true` to read ahead, `false` otherwise
+mxml_read_ahead_ok(
+    mxml_io_cb_t io_cb,			// I - Read callback function
+    void         *io_cbdata)		// I - Read callback data
+{
+#if !_WIN32
+  struct stat	fileinfo;		// File information
+
+
+  if (io_cb == (mxml_io_cb_t)mxml_read_cb_file)
+    return (!fstat(fileno((FILE *)io_cbdata), &fileinfo) && S_ISREG(fileinfo.st_mode));
+
+#else
+  (void)io_cb;
+  (void)io_cbdata;
+#endif // !_WIN32
+
+  return (true);
+}
+
+
+//
+// 'mxml_read_ahead_start()' - Start a thread to read ahead of the parser.
+//
+// The thread fills one buffer while the parser consumes the other, so reading
+// and parsing overlap.  Reads from a file descriptor wait for data with a
+// wake-up pipe so that @link mxml_read_ahead_stop@ can interrupt them.
+//
+
+static _mxml_readahead_t *		// O - Read-ahead thread data or `NULL` on error
+mxml_read_ahead_start(
+    mxml_options_t *options,		// I - Options
+    mxml_io_cb_t   io_cb,		// I - Read callback function
+    void           *io_cbdata)		// I - Read callback data
+{
+  _mxml_readahead_t	*ra;		// Read-ahead thread data
+
+
+  if ((ra = calloc(1, sizeof(_mxml_readahead_t))) == NULL)
+  {
+    _mxml_error(options, "Unable to allocate read-ahead buffers.");
+    return (NULL);
+  }
+
+  ra->io_cb     = io_cb;
+  ra->io_cbdata = io_cbdata;
+  ra->wake[0]   = -1;
+  ra->wake[1]   = -1;
+
+#if !_WIN32
+  if (io_cb == (mxml_io_cb_t)mxml_read_cb_fd && pipe(ra->wake))
+  {
+    _mxml_error(options, "Unable to create read-ahead pipe.");
+    free(ra);
+    return (NULL);
+  }
+#endif // !_WIN32
+
+  pthread_mutex_init(&ra->mutex, NULL);
+  pthread_cond_init(&ra->cond, NULL);
+
+  if (pthread_create(&ra->thread, NULL, (void *(*)(void *))mxml_read_ahead_thread, ra))
+  {
+    _mxml_error(options, "Unable to start read-ahead thread.");
+
+    if (ra->wake[0] >= 0)
+    {
+      close(ra->wake[0]);
+      close(ra->wake[1]);
+    }
+
+    pthread_cond_destroy(&ra->cond);
+    pthread_mutex_destroy(&ra->mutex);
+    free(ra);
+
+    return (NULL);
+  }
+
+  return (ra);
+}
+
+
+//
+// 'mxml_read_ahead_stop()' - Stop a read-ahead thread.
+//
+// This function waits for the thread to finish, interrupting a file descriptor
+// read that is waiting for data, so the thread never uses the source after the
+// load function returns.  The number of bytes the thread read that were not
+// passed to the parser is returned.
+//
+
+static size_t				// O - Bytes read but not used
+mxml_read_ahead_stop(
+    _mxml_readahead_t *ra)		// I - Read-ahead thread data
+{
+  size_t	unused = 0;		// Bytes read but not used
+
+
+  if (!ra)
+    return (0);
+
+  pthread_mutex_lock(&ra->mutex);
+  ra->stop = true;
+  pthread_cond_broadcast(&ra->cond);
+  pthread_mutex_unlock(&ra->mutex);
+
+  if (ra->wake[1] >= 0)
+  {
+    // Wake the thread if it is waiting for data...
+    while (write(ra->wake[1], "", 1) < 0 && errno == EINTR);
+  }
+
+  pthread_join(ra->thread, NULL);
+
+  // Count the data left in the buffers...
+  if (ra->full[ra->current])
+    unused += ra->bytes[ra->current] - ra->offset;
+  if (ra->full[ra->current ^ 1])
+    unused += ra->bytes[ra->current ^ 1];
+
+  if (ra->wake[0] >= 0)
+  {
+    close(ra->wake[0]);
+    close(ra->wake[1]);
+  }
+
+  pthread_cond_destroy(&ra->cond);
+  pthread_mutex_destroy(&ra->mutex);
+  free(ra);
+
+  return (unused);
+}
+
+
+//
+// 'mxml_read_ahead_thread()' - Fill buffers until the end of the data.
+//
+
+static void *				// O - Thread exit status (unused)
+mxml_read_ahead_thread(
+    _mxml_readahead_t *ra)		// I - Read-ahead thread data
+{
+  size_t	i = 0,			// Buffer to fill
+		bytes;			// Bytes read
+
+
+  pthread_mutex_lock(&ra->mutex);
+
+  while (!ra->stop)
+  {
+    // Wait for the parser to finish with the buffer...
+    if (ra->full[i])
+    {
+      pthread_cond_wait(&ra->cond, &ra->mutex);
+      continue;
+    }
+
+    // Fill it without holding the lock...
+    pthread_mutex_unlock(&ra->mutex);
+
+#if !_WIN32
+    if (ra->wake[0] >= 0)
+    {
+      struct pollfd	pfds[2];	// Poll data
+
+
+      // Wait for data or a wake-up...
+      pfds[0].fd     = *((int *)ra->io_cbdata);
+      pfds[0].events = POLLIN;
+      pfds[1].fd     = ra->wake[0];
+      pfds[1].events = POLLIN;
+
+      while (poll(pfds, 2, -1) < 0)
+      {
+        if (errno != EINTR && errno != EAGAIN)
+          break;
+      }
+
+      if (pfds[1].revents)
+      {
+        pthread_mutex_lock(&ra->mutex);
+        break;
+      }
+    }
+#endif // !_WIN32
+
+    bytes = (ra->io_cb)(ra->io_cbdata, ra->buffers[i], MXML_READ_SIZE);
+    pthread_mutex_lock(&ra->mutex);
+
+    ra->bytes[i] = bytes;
+    ra->full[i]  = true;
+    pthread_cond_broadcast(&ra->cond);
+
+    if (bytes == 0)
+      break;
+
+    i ^= 1;
+  }
+
+  pthread_mutex_unlock(&ra->mutex);
+
+  return (NULL);
+}
+#endif // HAVE_PTHREAD_H
+
+
+//
+// 'mxml_read_bytes()' - Read bytes from the read buffer, refilling as needed.
+//
+
+static bool				// O - `true` on success, `false` on EOF
+mxml_read_bytes(_mxml_read_t  *r,	// I - Read buffer
+                unsigned char *buffer,	// I - Buffer
+                size_t        bytes)	// I - Bytes to read
+{
+  size_t	rbytes;			// Bytes read from callback
+
+
+  while (bytes > 0)
+  {
+    if (r->bufptr >= r->bufend)
+    {
+      // Refill the buffer with the next block of data, if any...
+#ifdef HAVE_ZLIB_H
+      if (r->inflate)
+      {
+        if ((rbytes = mxml_read_inflate(r)) == 0)
+          return (false);
+      }
+      else
+#endif // HAVE_ZLIB_H
+      if (!r->io_cb || (rbytes = (r->io_cb)(r->io_cbdata, r->buffer, r->bufsize)) == 0)
+        return (false);
+
+      r->offset += (size_t)(r->bufend - r->buffer);
+      r->bufptr = r->buffer;
+      r->bufend = r->buffer + rbytes;
+    }
+
+    *buffer++ = *(r->bufptr)++;
+    bytes --;
+  }
+
+  return (true);
+}
+
+
+//
+// 'mxml_read_detect()' - Detect compressed data and setup decompression.
+//
+// The first bytes of the data are checked for a gzip header unless the options
+// disable or force decompression.  Compressed data is then decompressed a
+// block at a time into the read buffer by @code mxml_read_inflate@.
+//
+
+static bool				// O - `true` on success, `false` on error
+mxml_read_detect(
+    mxml_options_t *options,		// I - Options
+    _mxml_read_t   *r)			// I - Read buffer
+{
+  mxml_compression_t compression;	// Decompression of data
+  size_t	rbytes;			// Bytes read from callback
+#ifdef HAVE_ZLIB_H
+  _mxml_inflate_t *z;			// Decompression state
+#endif // HAVE_ZLIB_H
+
+
+  if ((compression = options ? options->compression : MXML_COMPRESSION_AUTO) == MXML_COMPRESSION_NONE)
+    return (true);
+
+  if (r->io_cb)
+  {
+    // Read enough data to check for the gzip header...
+    while ((r->bufend - r->bufptr) < 2 && (rbytes = (r->io_cb)(r->io_cbdata, r->bufend, r->bufsize - (size_t)(r->bufend - r->buffer))) > 0)
+      r->bufend += rbytes;
+  }
+
+  if (compression == MXML_COMPRESSION_AUTO && ((r->bufend - r->bufptr) < 2 || r->bufptr[0] != 0x1f || r->bufptr[1] != 0x8b))
+  {
+    // Not gzip data...
+    return (true);
+  }
+
+#ifdef HAVE_ZLIB_H
+  // Setup the decompression stream, accepting gzip and zlib headers...
+  if ((z = calloc(1, sizeof(_mxml_inflate_t))) == NULL)
+  {
+    _mxml_error(options, "Unable to allocate decompression buffer.");
+    return (false);
+  }
+
+  if (inflateInit2(&z->stream, 15 + 32) != Z_OK)
+  {
+    _mxml_error(options, "Unable to initialize decompression.");
+    free(z);
+    return (false);
+  }
+
+  if (r->io_cb)
+  {
+    // Decompress the data that has already been read first...
+    memcpy(z->buffer, r->bufptr, (size_t)(r->bufend - r->bufptr));
+
+    z->stream.next_in  = z->buffer;
+    z->stream.avail_in = (uInt)(r->bufend - r->bufptr);
+  }
+  else
+  {
+    // Decompress from memory into a new read buffer...
+    if ((r->buffer = malloc(MXML_READ_SIZE)) == NULL)
+    {
+      _mxml_error(options, "Unable to allocate read buffer.");
+      inflateEnd(&z->stream);
+      free(z);
+      return (false);
+    }
+
+    z->ptr     = r->bufptr;
+    z->end     = r->bufend;
+    r->bufsize = MXML_READ_SIZE;
+  }
+
+  r->bufptr  = r->buffer;
+  r->bufend  = r->buffer;
+  r->inflate = z;
+
+  return (true);
+
+#else
+  _mxml_error(options, "Compressed XML data is not supported.");
+  return (false);
+#endif // HAVE_ZLIB_H
+}
+
+
+//
+// 'mxml_read_free()' - Free the memory used by a read buffer.
+//
+// The buffer itself is only freed when it was allocated for a read callback or
+// for decompressed data.  Any read-ahead thread is stopped, and a file
+// descriptor or `FILE` pointer that can seek is moved back to the first byte
+// that was read but not used.
+//
+
+static void
+mxml_read_free(_mxml_read_t *r)		// I - Read buffer
+{
+  mxml_io_cb_t	io_cb = r->io_cb;	// Read callback function
+  void		*io_cbdata = r->io_cbdata;
+					// Read callback data
+  size_t	unused = 0;		// Bytes read but not used
+
+
+#ifdef HAVE_PTHREAD_H
+  if (r->readahead)
+  {
+    // Stop the thread, counting the data in its buffers...
+    io_cb        = r->readahead->io_cb;
+    io_cbdata    = r->readahead->io_cbdata;
+    unused       = mxml_read_ahead_stop(r->readahead);
+    r->readahead = NULL;
+  }
+#endif // HAVE_PTHREAD_H
+
+#ifdef HAVE_ZLIB_H
+  if (r->inflate)
+  {
+    // The amount of compressed data used is not known, so don't seek...
+    inflateEnd(&r->inflate->stream);
+    free(r->inflate);
+    free(r->buffer);
+  }
+  else
+#endif // HAVE_ZLIB_H
+  if (io_cb)
+  {
+    // Seek back over the data that was read but not used...
+    if ((unused += (size_t)(r->bufend - mxml_read_tell(r))) > 0)
+    {
+      if (io_cb == (mxml_io_cb_t)mxml_read_cb_fd)
+        lseek(*((int *)io_cbdata), -(off_t)unused, SEEK_CUR);
+      else if (io_cb == (mxml_io_cb_t)mxml_read_cb_file && unused <= LONG_MAX)
+        fseek((FILE *)io_cbdata, -(long)unused, SEEK_CUR);
+    }
+
+    free(r->buffer);
+  }
+
+  free(r->utf8);
+}
+
+
+#ifdef HAVE_ZLIB_H
+//
+// 'mxml_read_inflate()' - Decompress the next block of data into the read buffer.
+//
+// Concatenated gzip streams are decompressed one after another.  Corrupt or
+// truncated data sets the read error message.
+//
+
+static size_t				// O - Bytes decompressed or `0` on end of data
+mxml_read_inflate(_mxml_read_t *r)	// I - Read buffer
+{
+  _mxml_inflate_t *z = r->inflate;	// Decompression state
+  size_t	bytes;			// Bytes of compressed data
+  int		status;			// Decompression status
+
+
+  if (z->done)
+    return (0);
+
+  z->stream.next_out  = r->buffer;
+  z->stream.avail_out = (uInt)r->bufsize;
+
+  do
+  {
+    if (z->stream.avail_in == 0)
+    {
+      // Get more compressed data...
+      if (r->io_cb)
+      {
+        bytes             = (r->io_cb)(r->io_cbdata, z->buffer, sizeof(z->buffer));
+        z->stream.next_in = z->buffer;
+      }
+      else
+      {
+        if ((bytes = (size_t)(z->end - z->ptr)) > MXML_READ_SIZE)
+          bytes = MXML_READ_SIZE;
+
+        z->stream.next_in = (Bytef *)z->ptr;
+        z->ptr            += bytes;
+      }
+
+      if (bytes == 0)
+      {
+        if (!z->stream_end)
+        {
+          r->error     = "Compressed XML data is truncated.";
+          r->erroffset = r->offset + (size_t)(r->bufend - r->buffer) + (r->bufsize - z->stream.avail_out);
+        }
+
+        z->done = true;
+        break;
+      }
+
+      z->stream.avail_in = (uInt)bytes;
+    }
+
+    if (z->stream_end)
+    {
+      // Start the next gzip stream...
+      inflateReset(&z->stream);
+      z->stream_end = false;
+    }
+
+    if ((status = inflate(&z->stream, Z_NO_FLUSH)) == Z_STREAM_END)
+    {
+      z->stream_end = true;
+    }
+    else if (status != Z_OK && status != Z_BUF_ERROR)
+    {
+      r->error     = "Compressed XML data is corrupt.";
+      r->erroffset = r->offset + (size_t)(r->bufend - r->buffer) + (r->bufsize - z->stream.avail_out);
+      z->done      = true;
+      break;
+    }
+  }
+  while (z->stream.avail_out > 0);
+
+  return (r->bufsize - z->stream.avail_out);
+}
+#endif // HAVE_ZLIB_H
+
+
+//
+// 'mxml_read_open()' - Setup a read buffer for a read callback or memory.
+//
+// When `io_cb` is `NULL`, the `datalen` bytes at `data` are read in place.
+//
+
+static bool				// O - `true` on success, `false` on error
+mxml_read_open(
+    _mxml_read_t   *r,			// I - Read buffer
+    mxml_options_t *options,		// I - Options
+    mxml_io_cb_t   io_cb,		// I - Read callback function or `NULL` for memory
+    void           *io_cbdata,		// I - Read callback data
+    const void     *data,		// I - Data in memory
+    size_t         datalen)		// I - Length of data in memory
+{
+#ifdef HAVE_PTHREAD_H
+  r->readahead = NULL;
+#endif // HAVE_PTHREAD_H
+
+  if (io_cb)
+  {
+    // Allocate a buffer for the read callback...
+    if ((r->buffer = malloc(MXML_READ_SIZE)) == NULL)
+    {
+      _mxml_error(options, "Unable to allocate read buffer.");
+      return (false);
+    }
+
+    r->bufend  = r->buffer;
+    r->bufsize = MXML_READ_SIZE;
+
+#ifdef HAVE_PTHREAD_H
+    if (options && options->readahead && mxml_read_ahead_ok(io_cb, io_cbdata))
+    {
+      // Read from a separate thread while parsing...
+      if ((r->readahead = mxml_read_ahead_start(options, io_cb, io_cbdata)) == NULL)
+      {
+        free(r->buffer);
+        return (false);
+      }
+
+      io_cb     = (mxml_io_cb_t)mxml_read_cb_ahead;
+      io_cbdata = r->readahead;
+    }
+#endif // HAVE_PTHREAD_H
+  }
+  else
+  {
+    // Point at the data...
+    r->buffer  = (unsigned char *)data;
+    r->bufend  = r->buffer + datalen;
+    r->bufsize = datalen;
+  }
+
+  r->io_cb     = io_cb;
+  r->io_cbdata = io_cbdata;
+#ifdef HAVE_ZLIB_H
+  r->inflate   = NULL;
+#endif // HAVE_ZLIB_H
+  r->offset    = 0;
+  r->error     = NULL;
+  r->erroffset = 0;
+  r->encoding  = _MXML_ENCODING_UTF8;
+  r->partial   = false;
+  r->starved   = false;
+  r->bufptr    = r->buffer;
+  r->curptr    = NULL;
+  r->curend    = NULL;
+  r->utf8      = NULL;
+  r->tellptr   = NULL;
+  r->tellraw   = NULL;
+
+  // Check for compressed data...
+  if (!mxml_read_detect(options, r))
+  {
+    mxml_read_free(r);
+    return (false);
+  }
+
+  return (true);
+}
+
+
+//
+// 'mxml_read_quoted()' - Find a run of a quoted value in the validated UTF-8 data.
+//
+// This function returns the number of validated bytes starting at the current
+// position that come before the closing quote or an entity, adding any
+// newlines in them to the line number.  The bytes are checked 16 at a time
+// when SSE2 is available.
+//
+
+static size_t				// O  - Number of bytes before the quote or entity
+mxml_read_quoted(_mxml_read_t *r,	// I  - Read buffer
+                 int          quote,	// I  - Quote character
+                 int          *line)	// IO - Current line number
+{
+  const unsigned char	*start = r->curptr,
+					// Start of run
+			*ptr = r->curptr,
+					// Pointer into validated data
+			*end = r->curend;
+					// End of validated data
+
+
+  if (ptr >= end)
+    return (0);
+
+#ifdef __SSE2__
+  // Check 16 bytes at a time, counting newlines in each block...
+  const __m128i	q = _mm_set1_epi8((char)quote),
+		amp = _mm_set1_epi8('&'),
+		nl = _mm_set1_epi8('\n');
+
+  while ((end - ptr) >= 16)
+  {
+    __m128i	v = _mm_loadu_si128((const __m128i *)ptr);
+					// Next 16 bytes
+
+    if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, q), _mm_cmpeq_epi8(v, amp))))
+      break;
+
+    *line += __builtin_popcount((unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+    ptr   += 16;
+  }
+#endif // __SSE2__
+
+  // Check the remaining bytes...
+  while (ptr < end && *ptr != quote && *ptr != '&')
+  {
+    if (*ptr == '\n')
+      (*line)++;
+
+    ptr ++;
+  }
+
+  return ((size_t)(ptr - start));
+}
+
+
+//
+// 'mxml_read_span()' - Copy a run of characters of the given class.
+//
+// This function adds the validated bytes starting at the current position that
+// are all in the given character class to the buffer, leaving the first byte
+// that is not for the caller.
+//
+
+static bool				// O  - `true` on success, `false` on error
+mxml_read_span(
+    mxml_options_t *options,		// I  - Options
+    _mxml_read_t   *r,			// I  - Read buffer
+    int            cls,			// I  - Character class
+    char           **bufptr,		// IO - Current position in buffer
+    char           **buffer,		// IO - Current buffer
+    size_t         *bufsize)		// IO - Current buffer size
+{
+  unsigned char	*ptr = r->curptr,	// Pointer into validated data
+		*end = r->curend;	// End of validated data
+
+
+  while (ptr < end && (mxml_char_classes[*ptr] & cls))
+    ptr ++;
+
+  if (ptr > r->curptr)
+  {
+    if (!mxml_add_chars(options, r->curptr, (size_t)(ptr - r->curptr), bufptr, buffer, bufsize))
+      return (false);
+
+    r->curptr = ptr;
+  }
+
+  return (true);
+}
+
+
+//
+// 'mxml_read_tell()' - Get the current position in the read buffer.
+//
+// For UTF-16 data the position is found by counting the characters that have
+// been read from the UTF-8 buffer since the last call.
+//
+
+static unsigned char *			// O - Current position in buffer
+mxml_read_tell(_mxml_read_t *r)		// I - Read buffer
+{
+  int	ch;				// Current byte
+
+
+  if (r->curptr >= r->curend)
+  {
+    // No validated data left...
+    return (r->bufptr);
+  }
+  else if (r->encoding == _MXML_ENCODING_UTF8)
+  {
+    // Reading UTF-8 directly from the buffer...
+    return (r->curptr);
+  }
+
+  // Count the UTF-16 words used by each UTF-8 character...
+  while (r->tellptr < r->curptr)
+  {
+    if (((ch = *(r->tellptr)++) & 0xc0) != 0x80)
+      r->tellraw += ch >= 0xf0 ? 4 : 2;
+  }
+
+  return (r->tellraw);
+}
+
+
+//
+// 'mxml_read_text()' - Find a run of plain text in the validated UTF-8 data.
+//
+// This function returns the number of validated bytes starting at the current
+// position that can be copied as-is, stopping at the next '<', '&', newline,
+// and (optionally) whitespace character so that the caller can handle those
+// one at a time.  The bytes are checked 16 at a time when SSE2 is available.
+//
+
+static size_t				// O - Number of bytes of plain text
+mxml_read_text(_mxml_read_t *r,		// I - Read buffer
+               bool         spaces)	// I - Stop at whitespace?
+{
+  const unsigned char	*start = r->curptr,
+					// Start of run
+			*ptr = r->curptr,
+					// Pointer into validated data
+			*end = r->curend;
+					// End of validated data
+
+
+  if (ptr >= end)
+    return (0);
 
-	case MXML_TYPE_REAL :
-            node = mxmlNewReal(parent, mxml_strtod(options, buffer, &bufptr));
-	    break;
+#ifdef __SSE2__
+  // Check 16 bytes at a time - when not stopping at whitespace, the whitespace
+  // comparisons look for '<' a second time...
+  const __m128i	lt = _mm_set1_epi8('<'),
+		amp = _mm_set1_epi8('&'),
+		nl = _mm_set1_epi8('\n'),
+		space = _mm_set1_epi8(spaces ? ' ' : '<'),
+		tab = _mm_set1_epi8(spaces ? '\t' : '<'),
+		cr = _mm_set1_epi8(spaces ? '\r' : '<');
+
+  while ((end - ptr) >= 16)
+  {
+    __m128i	v = _mm_loadu_si128((const __m128i *)ptr);
+					// Next 16 bytes
+    __m128i	stop = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, lt), _mm_cmpeq_epi8(v, amp)), _mm_cmpeq_epi8(v, nl)), _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)), _mm_cmpeq_epi8(v, cr)));
+					// Bytes that end the run
 
-	case MXML_TYPE_TEXT :
-            node = mxmlNewText(parent, whitespace, buffer);
-	    break;
+    if (_mm_movemask_epi8(stop))
+      break;
 
-	case MXML_TYPE_CUSTOM :
-	    if (options && options->custload_cb)
-	    {
-	      // Use the callback to fill in the custom data...
-              node = mxmlNewCustom(parent, /*data*/NULL, /*free_cb*/NULL, /*free_cbdata*/NULL);
+    ptr += 16;
+  }
+#endif // __SSE2__
 
-	      if (!(options->custload_cb)(options->cust_cbdata, node, buffer))
-	      {
-	        _mxml_error(options, "Bad custom value '%s' in parent <%s> on line %d.", buffer, parent ? parent->value.element.name : "null", line);
-		mxmlDelete(node);
-		node = NULL;
-	      }
-	      break;
-	    }
+  // Check the remaining bytes...
+  int	stop = spaces ? _MXML_CHAR_SPACE : 0;
+					// Whitespace class, if any
 
-        default : // Ignore...
-	    node = NULL;
-	    break;
-      }
+  while (ptr < end && (mxml_char_classes[*ptr] & (_MXML_CHAR_TEXT | stop)) == _MXML_CHAR_TEXT)
+    ptr ++;
 
-      if (*bufptr)
-      {
-        // Bad integer/real number value...
-        _mxml_error(options, "Bad %s value '%s' in parent <%s> on line %d.", type == MXML_TYPE_INTEGER ? "integer" : "real", buffer, parent ? parent->value.element.name : "null", line);
-	break;
-      }
+  return ((size_t)(ptr - start));
+}
 
-      MXML_DEBUG("mxml_load_data: node=%p(%s), parent=%p\n", node, buffer, parent);
 
-      bufptr     = buffer;
-      whitespace = mxml_isspace(ch) && type == MXML_TYPE_TEXT;
+//
+// 'mxml_read_transcode()' - Transcode the UTF-16 data in the read buffer.
+//
+// This function converts as much of the buffered UTF-16 data as fits in the
+// UTF-8 buffer, stopping at control characters, invalid surrogate pairs, and
+// characters that are split across the end of the buffer so that
+// @code mxml_getc@ can report them.  Runs of ASCII characters are converted 16
+// characters at a time when SSE2 is available.
+//
 
-      if (!node && type != MXML_TYPE_IGNORE)
-      {
-        // Print error and return...
-	_mxml_error(options, "Unable to add value node of type %s to parent <%s> on line %d.", types[type], parent ? parent->value.element.name : "null", line);
-	goto error;
-      }
+static bool				// O - `true` if there is transcoded data, `false` otherwise
+mxml_read_transcode(_mxml_read_t *r)	// I - Read buffer
+{
+  unsigned char	*ptr = r->bufptr,	// Pointer into buffer
+		*end = r->bufend,	// End of buffer
+		*uptr,			// Pointer into UTF-8 buffer
+		*uend;			// End of UTF-8 buffer
+  int		ch,			// Current character
+		lch;			// Lower bits of surrogate pair
 
-      if (options && options->sax_cb)
-      {
-        if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_DATA))
-          goto error;
 
-        if (!mxmlRelease(node))
-          node = NULL;
-      }
+  // Allocate the UTF-8 buffer as needed...
+  if (!r->utf8 && (r->utf8 = malloc(MXML_READ_SIZE)) == NULL)
+    return (false);
 
-      if (!first && node)
-        first = node;
+  uptr = r->utf8;
+  uend = r->utf8 + MXML_READ_SIZE - 4;
+
+#ifdef __SSE2__
+  // Convert ASCII text 16 characters at a time - the high bits of each
+  // character must be 0, and the packed bytes are then checked for control
+  // characters...
+  const __m128i	himask = _mm_set1_epi16((short)0xff80),
+		zero = _mm_setzero_si128(),
+		space = _mm_set1_epi8(0x1f),
+		tab = _mm_set1_epi8('\t'),
+		nl = _mm_set1_epi8('\n'),
+		cr = _mm_set1_epi8('\r');
+  bool		swap = r->encoding == _MXML_ENCODING_UTF16BE;
+					// Swap bytes?
+
+  while ((end - ptr) >= 32 && (uend - uptr) >= 16)
+  {
+    __m128i	v1 = _mm_loadu_si128((const __m128i *)ptr),
+		v2 = _mm_loadu_si128((const __m128i *)(ptr + 16));
+					// Next 16 characters
+
+    if (swap)
+    {
+      v1 = _mm_or_si128(_mm_slli_epi16(v1, 8), _mm_srli_epi16(v1, 8));
+      v2 = _mm_or_si128(_mm_slli_epi16(v2, 8), _mm_srli_epi16(v2, 8));
     }
-    else if (mxml_isspace(ch) && type == MXML_TYPE_TEXT)
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(v1, v2), himask), zero)) != 0xffff)
+      break;
+
+    __m128i	v = _mm_packus_epi16(v1, v2);
+					// Packed ASCII characters
+    __m128i	ok = _mm_or_si128(_mm_or_si128(_mm_cmpgt_epi8(v, space), _mm_cmpeq_epi8(v, tab)), _mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, cr)));
+					// Valid ASCII bytes
+
+    if (_mm_movemask_epi8(ok) != 0xffff)
+      break;
+
+    _mm_storeu_si128((__m128i *)uptr, v);
+
+    ptr  += 32;
+    uptr += 16;
+  }
+#endif // __SSE2__
+
+  // Convert the remaining characters...
+  while ((end - ptr) >= 2 && uptr < uend)
+  {
+    if (r->encoding == _MXML_ENCODING_UTF16BE)
+      ch = (ptr[0] << 8) | ptr[1];
+    else
+      ch = ptr[0] | (ptr[1] << 8);
+
+    if (ch < 0x80)
     {
-      whitespace = true;
+      // ASCII
+      if (mxml_bad_char(ch))
+        break;
+
+      *uptr++ = (unsigned char)ch;
+      ptr += 2;
+    }
+    else if (ch < 0x800)
+    {
+      // Two-byte value...
+      *uptr++ = (unsigned char)(0xc0 | (ch >> 6));
+      *uptr++ = (unsigned char)(0x80 | (ch & 0x3f));
+      ptr += 2;
     }
+    else if (ch >= 0xd800 && ch <= 0xdbff)
+    {
+      // Multi-word UTF-16 char...
+      if ((end - ptr) < 4)
+        break;
 
-    if (ch == '\n')
-      line ++;
+      if (r->encoding == _MXML_ENCODING_UTF16BE)
+        lch = (ptr[2] << 8) | ptr[3];
+      else
+        lch = ptr[2] | (ptr[3] << 8);
 
-    // Add lone whitespace node if we have an element and existing whitespace...
-    if (ch == '<' && whitespace && type == MXML_TYPE_TEXT)
+      if (lch < 0xdc00 || lch >= 0xdfff)
+        break;
+
+      ch = (((ch & 0x3ff) << 10) | (lch & 0x3ff)) + 0x10000;
+
+      *uptr++ = (unsigned char)(0xf0 | (ch >> 18));
+      *uptr++ = (unsigned char)(0x80 | ((ch >> 12) & 0x3f));
+      *uptr++ = (unsigned char)(0x80 | ((ch >> 6) & 0x3f));
+      *uptr++ = (unsigned char)(0x80 | (ch & 0x3f));
+      ptr += 4;
+    }
+    else
     {
-      if (parent)
-      {
-	node = mxmlNewText(parent, whitespace, "");
+      // Three-byte value...
+      *uptr++ = (unsigned char)(0xe0 | (ch >> 12));
+      *uptr++ = (unsigned char)(0x80 | ((ch >> 6) & 0x3f));
+      *uptr++ = (unsigned char)(0x80 | (ch & 0x3f));
+      ptr += 2;
+    }
+  }
 
-	if (options && options->sax_cb)
-	{
-	  if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_DATA))
-	    goto error;
+  r->tellptr = r->utf8;
+  r->tellraw = r->bufptr;
+  r->bufptr  = ptr;
+  r->curptr  = r->utf8;
+  r->curend  = uptr;
 
-	  if (!mxmlRelease(node))
-	    node = NULL;
-	}
+  return (uptr > r->utf8);
+}
 
-	if (!first && node)
-	  first = node;
-      }
 
-      whitespace = false;
+//
+// 'mxml_read_until()' - Find the body of a comment, CDATA, or processing instruction.
+//
+// This function returns the number of validated bytes starting at the current
+// position that come before the terminator string ("-->", "]]>", or "?>"),
+// adding any newlines in them to the line number.  Since the start of the
+// terminator may already be in the caller's buffer, nothing is returned when
+// there is a '>' closer to the start than the length of the terminator.  The
+// caller checks the terminator one character at a time as before.  The bytes
+// are checked 16 at a time when SSE2 is available.
+//
+
+static size_t				// O  - Number of bytes before the terminator
+mxml_read_until(_mxml_read_t *r,	// I  - Read buffer
+                const char   *term,	// I  - Terminator string
+                int          *line)	// IO - Current line number
+{
+  const unsigned char	*start = r->curptr,
+					// Start of run
+			*ptr = r->curptr,
+					// Pointer into validated data
+			*end = r->curend;
+					// End of validated data
+  size_t		termlen = strlen(term);
+					// Length of terminator
+
+
+  // Let the caller check a '>' that might finish a partial terminator...
+  for (; ptr < end && (size_t)(ptr - start) < (termlen - 1); ptr ++)
+  {
+    if (*ptr == '>')
+      return (0);
+  }
+
+  ptr = start;
+
+#ifdef __SSE2__
+  // Look for the whole terminator 16 positions at a time, counting newlines
+  // in each block...
+  const __m128i	t0 = _mm_set1_epi8(term[0]),
+		t1 = _mm_set1_epi8(term[1]),
+		t2 = _mm_set1_epi8(termlen > 2 ? term[2] : term[1]),
+		nl = _mm_set1_epi8('\n');
+
+  while ((end - ptr) >= (ptrdiff_t)(16 + termlen - 1))
+  {
+    __m128i	v = _mm_loadu_si128((const __m128i *)ptr);
+					// Next 16 bytes
+    __m128i	found = _mm_and_si128(_mm_cmpeq_epi8(v, t0), _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(ptr + 1)), t1));
+					// Terminator matches
+
+    if (termlen > 2)
+      found = _mm_and_si128(found, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(ptr + 2)), t2));
+
+    if (_mm_movemask_epi8(found))
+      break;
+
+    *line += __builtin_popcount((unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+    ptr   += 16;
+  }
+#endif // __SSE2__
+
+  // Check the remaining bytes, stopping at anything that might be part of the
+  // terminator...
+  while (ptr < end && *ptr != term[0] && *ptr != '>')
+  {
+    if (*ptr == '\n')
+      (*line)++;
+
+    ptr ++;
+  }
+
+  return ((size_t)(ptr - start));
+}
+
+
+//
+// 'mxml_read_validate()' - Validate the data in the read buffer.
+//
+// This function checks as much of the buffered UTF-8 data as possible,
+// stopping at control characters, byte order marks, invalid or overlong
+// sequences, and sequences that are split across the end of the buffer.  The
+// validated data can then be decoded by @code mxml_getc@ without any further
+// checks, and pure ASCII is checked 16 bytes at a time when SSE2 is available.
+// UTF-16 data is converted to UTF-8 using @code mxml_read_transcode@.
+//
+
+static bool				// O - `true` if there is validated data, `false` otherwise
+mxml_read_validate(_mxml_read_t *r)	// I - Read buffer
+{
+  unsigned char	*ptr = r->bufptr,	// Pointer into buffer
+		*end = r->bufend;	// End of buffer
+  int		ch;			// Current character
+
+
+  if (r->encoding != _MXML_ENCODING_UTF8)
+    return (mxml_read_transcode(r));
+
+
+#ifdef __SSE2__
+  // Check ASCII text 16 bytes at a time - bytes from 0x20 to 0x7f are signed
+  // values greater than 0x1f...
+  const __m128i	space = _mm_set1_epi8(0x1f),
+		tab = _mm_set1_epi8('\t'),
+		nl = _mm_set1_epi8('\n'),
+		cr = _mm_set1_epi8('\r');
+
+  while ((end - ptr) >= 16)
+  {
+    __m128i	v = _mm_loadu_si128((const __m128i *)ptr);
+					// Next 16 bytes
+    __m128i	ok = _mm_or_si128(_mm_or_si128(_mm_cmpgt_epi8(v, space), _mm_cmpeq_epi8(v, tab)), _mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, cr)));
+					// Valid ASCII bytes
+
+    if (_mm_movemask_epi8(ok) != 0xffff)
+      break;
+
+    ptr += 16;
+  }
+#endif // __SSE2__
+
+  // Check the remaining bytes and any multi-byte sequences...
+  while (ptr < end)
+  {
+    ch = *ptr;
+
+    if (ch < 0x80)
+    {
+      // ASCII
+      if (mxml_bad_char(ch))
+        break;
+
+      ptr ++;
     }
+    else if ((ch & 0xe0) == 0xc0)
+    {
+      // Two-byte value...
+      if ((end - ptr) < 2 || (ptr[1] & 0xc0) != 0x80 || ch < 0xc2)
+        break;
 
-    if (ch == '<')
+      ptr += 2;
+    }
+    else if ((ch & 0xf0) == 0xe0)
     {
-      // Start of open/close tag...
-      bufptr = buffer;
+      // Three-byte value, which must not be overlong or a byte order mark...
+      if ((end - ptr) < 3 || (ptr[1] & 0xc0) != 0x80 || (ptr[2] & 0xc0) != 0x80)
+        break;
 
-      while ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != EOF)
-      {
-        if (mxml_isspace(ch) || ch == '>' || (ch == '/' && bufptr > buffer))
-        {
-	  break;
-	}
-	else if (ch == '<')
-	{
-	  _mxml_error(options, "Bare < in element.");
-	  goto error;
-	}
-	else if (ch == '&')
-	{
-	  if ((ch = mxml_get_entity(options, io_cb, io_cbdata, &encoding, parent, &line)) == EOF)
-	    goto error;
+      ch = ((ch & 0x0f) << 12) | ((ptr[1] & 0x3f) << 6) | (ptr[2] & 0x3f);
 
-	  if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	    goto error;
-	}
-	else if (ch < '0' && ch != '!' && ch != '-' && ch != '.' && ch != '/')
-	{
-	  goto error;
-	}
-	else if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	{
-	  goto error;
-	}
-	else if (((bufptr - buffer) == 1 && buffer[0] == '?') || ((bufptr - buffer) == 3 && !strncmp(buffer, "!--", 3)) || ((bufptr - buffer) == 8 && !strncmp(buffer, "![CDATA[", 8)))
-	{
-	  break;
-	}
+      if (ch < 0x800 || ch == 0xfeff)
+        break;
 
-	if (ch == '\n')
-	  line ++;
-      }
+      ptr += 3;
+    }
+    else if ((ch & 0xf8) == 0xf0)
+    {
+      // Four-byte value...
+      if ((end - ptr) < 4 || (ptr[1] & 0xc0) != 0x80 || (ptr[2] & 0xc0) != 0x80 || (ptr[3] & 0xc0) != 0x80)
+        break;
 
-      *bufptr = '\0';
+      ch = ((ch & 0x07) << 18) | ((ptr[1] & 0x3f) << 12) | ((ptr[2] & 0x3f) << 6) | (ptr[3] & 0x3f);
 
-      if (!strcmp(buffer, "!--"))
-      {
-        // Gather rest of comment...
-	while ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != EOF)
-	{
-	  if (ch == '>' && bufptr > (buffer + 4) && bufptr[-3] != '-' && bufptr[-2] == '-' && bufptr[-1] == '-')
-	    break;
-	  else if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	    goto error;
+      if (ch < 0x10000)
+        break;
 
-	  if (ch == '\n')
-	    line ++;
-	}
+      ptr += 4;
+    }
+    else
+    {
+      // Invalid byte or UTF-16 byte order mark...
+      break;
+    }
+  }
 
-        // Error out if we didn't get the whole comment...
-        if (ch != '>')
-	{
-	  // Print error and return...
-	  _mxml_error(options, "Early EOF in comment node on line %d.", line);
-	  goto error;
-	}
+  if (ptr == r->bufptr)
+    return (false);
 
-        // Otherwise add this as an element under the current parent...
-	bufptr[-2] = '\0';
+  r->curptr = r->bufptr;
+  r->curend = ptr;
+  r->bufptr = ptr;
 
-        if (!parent && first)
-	{
-	  // There can only be one root element!
-	  _mxml_error(options, "<%s--> cannot be a second root node after <%s> on line %d.", buffer, first->value.element.name, line);
-          goto error;
-	}
+  return (true);
+}
+
+
+#ifdef HAVE_PTHREAD_H
+//
+// 'mxml_read_cb_ahead()' - Read bytes from a read-ahead thread.
+//
+// A buffer that has been filled by the thread is copied and handed back to be
+// filled again.  An empty buffer marks the end of the data and is never handed
+// back.
+//
+
+static size_t				// O - Bytes read
+mxml_read_cb_ahead(
+    _mxml_readahead_t *ra,		// I - Read-ahead thread data
+    void              *buffer,		// I - Buffer
+    size_t            bytes)		// I - Bytes to read
+{
+  size_t	i,			// Current buffer
+		avail;			// Bytes available in buffer
+
+
+  pthread_mutex_lock(&ra->mutex);
+
+  i = ra->current;
+
+  while (!ra->full[i])
+    pthread_cond_wait(&ra->cond, &ra->mutex);
+
+  if ((avail = ra->bytes[i] - ra->offset) > bytes)
+    avail = bytes;
+
+  pthread_mutex_unlock(&ra->mutex);
+
+  // Copy outside the lock since the thread won't touch a full buffer...
+  memcpy(buffer, ra->buffers[i] + ra->offset, avail);
+
+  if (avail > 0 && (ra->offset += avail) >= ra->bytes[i])
+  {
+    // Hand the buffer back to the thread...
+    pthread_mutex_lock(&ra->mutex);
+
+    ra->full[i] = false;
+    ra->current = i ^ 1;
+    ra->offset  = 0;
+    pthread_cond_broadcast(&ra->cond);
+
+    pthread_mutex_unlock(&ra->mutex);
+  }
+
+  return (avail);
+}
+#endif // HAVE_PTHREAD_H
+
+
+//
+// 'mxml_read_cb_fd()' - Read bytes from a file descriptor.
+//
+
+static size_t				// O - Bytes read
+mxml_read_cb_fd(int    *fd,		// I - File descriptor
+                void   *buffer,		// I - Buffer
+                size_t bytes)		// I - Bytes to read
+{
+#if _WIN32
+  int		rbytes;			// Bytes read
+
+
+  rbytes = read(*fd, buffer, bytes);
 
-	if ((node = mxmlNewComment(parent, buffer + 3)) == NULL)
-	{
-	  // Just print error for now...
-	  _mxml_error(options, "Unable to add comment node to parent <%s> on line %d.", parent ? parent->value.element.name : "null", line);
-	  break;
-	}
+#else
+  ssize_t	rbytes;			// Bytes read
 
-	MXML_DEBUG("mxml_load_data: node=%p(<%s-->), parent=%p\n", node, buffer, parent);
 
-        if (options && options->sax_cb)
-        {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_COMMENT))
-	    goto error;
+  while ((rbytes = read(*fd, buffer, bytes)) < 0)
+  {
+    if (errno != EINTR && errno != EAGAIN)
+      break;
+  }
+#endif // _WIN32
 
-          if (!mxmlRelease(node))
-            node = NULL;
-        }
+  if (rbytes < 0)
+    return (0);
+  else
+    return ((size_t)rbytes);
+}
 
-	if (node && !first)
-	  first = node;
-      }
-      else if (!strcmp(buffer, "![CDATA["))
-      {
-        // Gather CDATA section...
-	while ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != EOF)
-	{
-	  if (ch == '>' && !strncmp(bufptr - 2, "]]", 2))
-	  {
-	    // Drop terminator from CDATA string...
-	    bufptr[-2] = '\0';
-	    break;
-	  }
-	  else if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	  {
-	    goto error;
-	  }
 
-	  if (ch == '\n')
-	    line ++;
-	}
+//
+// 'mxml_read_cb_file()' - Read bytes from a file pointer.
+//
 
-        // Error out if we didn't get the whole comment...
-        if (ch != '>')
-	{
-	  // Print error and return...
-	  _mxml_error(options, "Early EOF in CDATA node on line %d.", line);
-	  goto error;
-	}
+static size_t				// O - Bytes read
+mxml_read_cb_file(FILE   *fp,		// I - File pointer
+                  void   *buffer,	// I - Buffer
+                  size_t bytes)		// I - Bytes to read
+{
+  if (feof(fp))
+    return (0);
+  else
+    return (fread(buffer, 1, bytes, fp));
+}
 
-        // Otherwise add this as an element under the current parent...
-	bufptr[-2] = '\0';
 
-        if (!parent && first)
-	{
-	  // There can only be one root element!
-	  _mxml_error(options, "<%s]]> cannot be a second root node after <%s> on line %d.", buffer, first->value.element.name, line);
-          goto error;
-	}
+//
+// 'mxml_reader_cb()' - Save an event for the pull parser.
+//
+// Parsing stops after the event so the caller can use its data.
+//
 
-	if ((node = mxmlNewCDATA(parent, buffer + 8)) == NULL)
-	{
-	  // Print error and return...
-	  _mxml_error(options, "Unable to add CDATA node to parent <%s> on line %d.", parent ? parent->value.element.name : "null", line);
-	  goto error;
-	}
+static bool				// O - `true` to continue, `false` on error
+mxml_reader_cb(
+    mxml_reader_t    *reader,		// I - Pull parser
+    mxml_sax_event_t event,		// I - Event
+    const char       *data,		// I - Name or text
+    size_t           datalen,		// I - Length of name or text
+    mxml_attrs_t     *attrs)		// I - Attributes or `NULL`
+{
+  size_t	i = reader->num_events;	// Event index
 
-	MXML_DEBUG("mxml_load_data: node=%p(<%s]]>), parent=%p\n", node, buffer, parent);
 
-        if (options && options->sax_cb)
-        {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_CDATA))
-	    goto error;
+  if (i >= (sizeof(reader->events) / sizeof(reader->events[0])))
+    return (false);
 
-          if (!mxmlRelease(node))
-            node = NULL;
-        }
+  reader->events[i]  = event;
+  reader->data[i]    = data;
+  reader->datalen[i] = datalen;
+  reader->num_events ++;
 
-	if (node && !first)
-	  first = node;
-      }
-      else if (buffer[0] == '?')
-      {
-        // Gather rest of processing instruction...
-	while ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != EOF)
-	{
-	  if (ch == '>' && bufptr > buffer && bufptr[-1] == '?')
-	    break;
-	  else if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	    goto error;
+  if (attrs)
+    reader->attrs = *attrs;
 
-	  if (ch == '\n')
-	    line ++;
-	}
+  reader->l.paused = true;
 
-        // Error out if we didn't get the whole processing instruction...
-        if (ch != '>')
-	{
-	  // Print error and return...
-	  _mxml_error(options, "Early EOF in processing instruction node on line %d.", line);
-	  goto error;
-	}
+  return (true);
+}
 
-        // Otherwise add this as an element under the current parent...
-	bufptr[-1] = '\0';
 
-        if (!parent && first)
-	{
-	  // There can only be one root element!
-	  _mxml_error(options, "<%s?> cannot be a second root node after <%s> on line %d.", buffer, first->value.element.name, line);
-          goto error;
-	}
+//
+// 'mxml_reader_new()' - Create a pull parser.
+//
+// When `fd` is not `-1` the pull parser reads from the file descriptor,
+// otherwise it reads using `io_cb` or from memory when `io_cb` is `NULL`.
+//
 
-	if ((node = mxmlNewDirective(parent, buffer + 1)) == NULL)
-	{
-	  // Print error and return...
-	  _mxml_error(options, "Unable to add processing instruction node to parent <%s> on line %d.", parent ? parent->value.element.name : "null", line);
-	  goto error;
-	}
+static mxml_reader_t *			// O - Pull parser or `NULL` on error
+mxml_reader_new(
+    mxml_options_t *options,		// I - Options
+    int            fd,			// I - File descriptor or `-1`
+    mxml_io_cb_t   io_cb,		// I - Read callback function or `NULL`
+    void           *io_cbdata,		// I - Read callback data
+    const void     *data,		// I - Data in memory
+    size_t         datalen)		// I - Length of data in memory
+{
+  mxml_reader_t	*reader;		// Pull parser
 
-	MXML_DEBUG("mxml_load_data: node=%p(<%s?>), parent=%p\n", node, buffer, parent);
 
-        if (options && options->sax_cb)
-        {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_DIRECTIVE))
-	    goto error;
+  // Create a new pull parser...
+  if ((reader = calloc(1, sizeof(mxml_reader_t))) == NULL)
+  {
+    _mxml_error(options, "Unable to allocate pull parser.");
+    return (NULL);
+  }
 
-          if (strncmp(node->value.directive, "xml ", 4) && !mxmlRelease(node))
-            node = NULL;
-        }
+  // Copy the options and report events to the pull parser...
+  if (options)
+    reader->options = *options;
 
-        if (node)
-	{
-	  if (!first)
-            first = node;
+  reader->options.sax_cb       = NULL;
+  reader->options.event_cb     = (mxml_event_cb_t)mxml_reader_cb;
+  reader->options.event_cbdata = reader;
+  reader->options.num_filters  = 0;
+  reader->options.lazy         = false;
+  reader->fd                   = fd;
 
-	  if (!parent)
-	  {
-	    parent = node;
+  if (fd >= 0)
+  {
+    io_cb     = (mxml_io_cb_t)mxml_read_cb_fd;
+    io_cbdata = &reader->fd;
+  }
 
-	    if (options && options->type_cb)
-	      type = (options->type_cb)(options->type_cbdata, parent);
-	    else if (options)
-	      type = options->type_value;
-	    else
-	      type = MXML_TYPE_TEXT;
-	  }
-	}
-      }
-      else if (buffer[0] == '!')
-      {
-        // Gather rest of declaration...
-	do
-	{
-	  if (ch == '>')
-	  {
-	    break;
-	  }
-	  else
-	  {
-            if (ch == '&')
-            {
-	      if ((ch = mxml_get_entity(options, io_cb, io_cbdata, &encoding, parent, &line)) == EOF)
-		goto error;
-            }
+  if (!mxml_read_open(&reader->r, &reader->options, io_cb, io_cbdata, data, datalen))
+  {
+    free(reader);
+    return (NULL);
+  }
 
-	    if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	      goto error;
-	  }
+  if (!mxml_load_init(&reader->l, /*top*/NULL, &reader->options))
+  {
+    mxml_read_free(&reader->r);
+    free(reader);
+    return (NULL);
+  }
 
-	  if (ch == '\n')
-	    line ++;
-	}
-        while ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != EOF);
+  return (reader);
+}
 
-        // Error out if we didn't get the whole declaration...
-        if (ch != '>')
-	{
-	  // Print error and return...
-	  _mxml_error(options, "Early EOF in declaration node on line %d.", line);
-	  goto error;
-	}
 
-        // Otherwise add this as an element under the current parent...
-	*bufptr = '\0';
+#ifdef HAVE_PTHREAD_H
+//
+// 'mxml_scan_root()' - Find the end of the root element's open tag.
+//
+// Only the markup is scanned, so the result is confirmed by loading the data
+// up to the returned position.  `NULL` is returned for data that does not look
+// like UTF-8 XML with a root element that can have children.
+//
 
-        if (!parent && first)
-	{
-	  // There can only be one root element!
-	  _mxml_error(options, "<%s> cannot be a second root node after <%s> on line %d.", buffer, first->value.element.name, line);
-          goto error;
-	}
+static const unsigned char *		// O - End of open tag or `NULL` if not found
+mxml_scan_root(
+    const unsigned char *data,		// I - Data
+    size_t              datalen)	// I - Length of data
+{
+  const unsigned char	*ptr = data,	// Pointer into data
+			*end = data + datalen,
+					// End of data
+			*name;		// Name of root element
+  int			quote = 0,	// Current quote character
+			brackets = 0;	// Nesting of internal DTD subset
 
-	if ((node = mxmlNewDeclaration(parent, buffer + 1)) == NULL)
-	{
-	  // Print error and return...
-	  _mxml_error(options, "Unable to add declaration node to parent <%s> on line %d.", parent ? parent->value.element.name : "null", line);
-	  goto error;
-	}
 
-	MXML_DEBUG("mxml_load_data: node=%p(<%s>), parent=%p\n", node, buffer, parent);
+  // Skip any UTF-8 byte order mark...
+  if (datalen >= 3 && !memcmp(ptr, "\357\273\277", 3))
+    ptr += 3;
 
-        if (options && options->sax_cb)
-        {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_DECLARATION))
-	    goto error;
+  // Skip any processing instructions, comments, and declarations before the
+  // root element...
+  for (;;)
+  {
+    while (ptr < end && mxml_isspace(*ptr))
+      ptr ++;
 
-          if (!mxmlRelease(node))
-            node = NULL;
+    if ((end - ptr) < 2 || *ptr != '<')
+      return (NULL);
+
+    if (ptr[1] == '?')
+    {
+      ptr = mxml_find_string(ptr + 2, end, "?>");
+    }
+    else if ((end - ptr) >= 4 && !memcmp(ptr, "<!--", 4))
+    {
+      ptr = mxml_find_string(ptr + 4, end, "-->");
+    }
+    else if (ptr[1] == '!')
+    {
+      for (ptr += 2; ptr < end; ptr ++)
+      {
+        if (quote)
+        {
+          if (*ptr == quote)
+            quote = 0;
         }
+        else if (*ptr == '\"' || *ptr == '\'')
+          quote = *ptr;
+        else if (*ptr == '[')
+          brackets ++;
+        else if (*ptr == ']')
+          brackets --;
+        else if (*ptr == '>' && brackets <= 0)
+          break;
+      }
 
-        if (node)
-	{
-	  if (!first)
-            first = node;
+      ptr = ptr < end ? ptr + 1 : NULL;
+    }
+    else
+    {
+      break;
+    }
 
-	  if (!parent)
-	  {
-	    parent = node;
+    if (!ptr)
+      return (NULL);
+  }
 
-	    if (options && options->type_cb)
-	      type = (options->type_cb)(options->type_cbdata, parent);
-	    else if (options)
-	      type = options->type_value;
-	    else
-	      type = MXML_TYPE_TEXT;
-	  }
-	}
-      }
-      else if (buffer[0] == '/')
-      {
-        // Handle close tag...
-	MXML_DEBUG("mxml_load_data: <%s>, parent=%p\n", buffer, parent);
+  // Skip the name and attributes of the root element...
+  for (name = ptr + 1, ptr = name; ptr < end && (mxml_char_class(*ptr) & _MXML_CHAR_TAG); ptr ++);
 
-        if (!parent || strcmp(buffer + 1, parent->value.element.name))
-	{
-	  // Close tag doesn't match tree; print an error for now...
-	  _mxml_error(options, "Mismatched close tag <%s> under parent <%s> on line %d.", buffer, parent ? parent->value.element.name : "(null)", line);
-          goto error;
-	}
+  if (ptr == name)
+    return (NULL);
+
+  for (; ptr < end; ptr ++)
+  {
+    if (quote)
+    {
+      if (*ptr == quote)
+        quote = 0;
+    }
+    else if (*ptr == '\"' || *ptr == '\'')
+      quote = *ptr;
+    else if (*ptr == '>')
+      break;
+  }
 
-        // Keep reading until we see >...
-        while (ch != '>' && ch != EOF)
-	  ch = mxml_getc(options, io_cb, io_cbdata, &encoding);
+  if (ptr >= end || ptr[-1] == '/')
+    return (NULL);
 
-        node   = parent;
-        parent = parent->parent;
+  return (ptr + 1);
+}
+#endif // HAVE_PTHREAD_H
 
-        if (options && options->sax_cb)
-        {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_ELEMENT_CLOSE))
-	    goto error;
 
-          if (!mxmlRelease(node))
-          {
-            if (first == node)
-	      first = NULL;
+//
+// 'mxml_skip_element()' - Skip an element without loading it.
+//
+// The open tag is skipped from the character after the element name, followed
+// by the contents of the element up to the matching close tag.  Nested tags are
+// counted without checking their names, and entities are not decoded.  When
+// reading pushed data, skipping resumes with the current text or markup once
+// more data is pushed.
+//
 
-	    node = NULL;
-	  }
-        }
+static int				// O  - Last character read or `EOF` on error
+mxml_skip_element(
+    _mxml_load_t   *l,			// I  - Load data
+    mxml_options_t *options,		// I  - Options
+    _mxml_read_t   *r,			// I  - Read buffer
+    int            ch,			// I  - Character after element name
+    int            *line)		// IO - Current line number
+{
+  size_t	depth = l->skip_depth;	// Depth of nested elements
+  bool		intag = depth == 0;	// Skipping the rest of an open tag?
+  int		quote,			// Current quote character
+		prev;			// Previous character
 
-        // Ascend into the parent and set the value type as needed...
-	if (options && options->type_cb && parent)
-	  type = (options->type_cb)(options->type_cbdata, parent);
-	else if (options && !options->type_cb)
-	  type = options->type_value;
-      }
-      else
+
+  for (;;)
+  {
+    if (intag)
+    {
+      // Skip the rest of the open tag, including any quoted values...
+      for (quote = 0, prev = 0; ch != EOF && (quote || ch != '>'); prev = ch, ch = mxml_getc(options, r))
       {
-        // Handle open tag...
-        if (!parent && first)
-	{
-	  // There can only be one root element!
-	  _mxml_error(options, "<%s> cannot be a second root node after <%s> on line %d.", buffer, first->value.element.name, line);
-          goto error;
-	}
+	if (ch == '\n')
+	  (*line) ++;
 
-        if ((node = mxmlNewElement(parent, buffer)) == NULL)
+	if (quote)
 	{
-	  // Just print error for now...
-	  _mxml_error(options, "Unable to add element node to parent <%s> on line %d.", parent ? parent->value.element.name : "null", line);
-	  goto error;
+	  if (ch == quote)
+	    quote = 0;
+	  else
+	    r->curptr += mxml_read_quoted(r, quote, line);
 	}
-
-        if (mxml_isspace(ch))
-        {
-	  MXML_DEBUG("mxml_load_data: node=%p(<%s...>), parent=%p\n", node, buffer, parent);
-
-	  if ((ch = mxml_parse_element(options, io_cb, io_cbdata, node, &encoding, &line)) == EOF)
-	    goto error;
-        }
-        else if (ch == '/')
+	else if (ch == '\"' || ch == '\'')
 	{
-	  MXML_DEBUG("mxml_load_data: node=%p(<%s/>), parent=%p\n", node, buffer, parent);
-
-	  if ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != '>')
-	  {
-	    _mxml_error(options, "Expected > but got '%c' instead for element <%s/> on line %d.", ch, buffer, line);
-            mxmlDelete(node);
-            node = NULL;
-            goto error;
-	  }
-
-	  ch = '/';
+	  quote = ch;
 	}
+      }
 
-        if (options && options->sax_cb)
-        {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_ELEMENT_OPEN))
-	    goto error;
-	}
+      if (ch == EOF)
+	return (EOF);
 
-        if (!first)
-	  first = node;
+      if (prev != '/')
+	depth ++;
 
-	if (ch == EOF)
-	  break;
+      if (depth == 0)
+        break;
 
-        if (ch != '/')
-	{
-	  // Descend into this node, setting the value type as needed...
-	  parent = node;
+      intag = false;
+    }
 
-	  if (options && options->type_cb && parent)
-	    type = (options->type_cb)(options->type_cbdata, parent);
-	  else if (options && !options->type_cb)
-	    type = options->type_value;
-	  else
-	    type = MXML_TYPE_TEXT;
-	}
-        else if (options && options->sax_cb)
-        {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_ELEMENT_CLOSE))
-	    goto error;
+    if (r->partial)
+    {
+      // Save the start of the contents in case we run out of pushed data...
+      l->state      = _MXML_LSTATE_SKIP;
+      l->skip_depth = depth;
+      l->line       = *line;
+      l->buflen     = 0;
+      l->pos        = mxml_read_tell(r);
+      l->encoding   = r->encoding;
+    }
 
-          if (!mxmlRelease(node))
-          {
-            if (first == node)
-	      first = NULL;
+    // Skip text up to the next tag...
+    while ((ch = mxml_getc(options, r)) != EOF && ch != '<')
+    {
+      if (ch == '\n')
+	(*line) ++;
 
-	    node = NULL;
-	  }
-        }
-      }
+      r->curptr += mxml_read_text(r, /*spaces*/false);
+    }
 
-      bufptr  = buffer;
+    if (ch == EOF || (ch = mxml_getc(options, r)) == EOF)
+      return (EOF);
+
+    if (ch == '/')
+    {
+      // Close tag...
+      ch = mxml_skip_until(options, r, ">", line);
+      depth --;
     }
-    else if (ch == '&')
+    else if (ch == '?')
     {
-      // Add character entity to current buffer...
-      if ((ch = mxml_get_entity(options, io_cb, io_cbdata, &encoding, parent, &line)) == EOF)
-	goto error;
-
-      if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	goto error;
+      // Processing instruction...
+      ch = mxml_skip_until(options, r, "?>", line);
     }
-    else if (type == MXML_TYPE_OPAQUE || type == MXML_TYPE_CUSTOM || !mxml_isspace(ch))
+    else if (ch == '!')
     {
-      // Add character to current buffer...
-      if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	goto error;
+      // Comment, CDATA, or declaration...
+      if ((ch = mxml_getc(options, r)) == '-')
+	ch = mxml_skip_until(options, r, "-->", line);
+      else if (ch == '[')
+	ch = mxml_skip_until(options, r, "]]>", line);
+      else if (ch != '>' && ch != EOF)
+	ch = mxml_skip_until(options, r, ">", line);
+    }
+    else
+    {
+      // Open tag...
+      intag = true;
     }
+
+    if (ch == EOF)
+      return (EOF);
+    else if (depth == 0)
+      break;
   }
-  while ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != EOF);
 
-  // Free the string buffer - we don't need it anymore...
-  free(buffer);
+  l->skip_depth = 0;
 
-  // Find the top element and return it...
-  if (parent)
-  {
-    node = parent;
+  return (ch);
+}
 
-    while (parent != top && parent->parent)
-      parent = parent->parent;
 
-    if (node != parent)
-    {
-      _mxml_error(options, "Missing close tag </%s> under parent <%s> on line %d.", mxmlGetElement(node), node->parent ? node->parent->value.element.name : "(null)", line);
+//
+// 'mxml_skip_until()' - Skip data up to and including a terminator string.
+//
+// The terminator is one to three characters ending with '>'.
+//
 
-      mxmlDelete(first);
+static int				// O  - Last character read or `EOF` on error
+mxml_skip_until(
+    mxml_options_t *options,		// I  - Options
+    _mxml_read_t   *r,			// I  - Read buffer
+    const char     *term,		// I  - Terminator string
+    int            *line)		// IO - Current line number
+{
+  int		ch,			// Current character
+		prev1 = 0,		// Previous character
+		prev2 = 0;		// Character before that
+  size_t	len,			// Length of data before terminator
+		termlen = strlen(term);	// Length of terminator
 
-      return (NULL);
-    }
-  }
 
-  if (parent)
-    return (parent);
-  else
-    return (first);
+  while ((ch = mxml_getc(options, r)) != EOF)
+  {
+    if (ch == '>' && (termlen < 2 || prev1 == term[termlen - 2]) && (termlen < 3 || prev2 == term[termlen - 3]))
+      break;
 
-  // Common error return...
-  error:
+    if (ch == '\n')
+      (*line) ++;
 
-  mxmlDelete(first);
+    prev2 = prev1;
+    prev1 = ch;
 
-  free(buffer);
+    // Skip everything up to the next possible terminator...
+    if (termlen > 1 && (len = mxml_read_until(r, term, line)) > 0)
+    {
+      prev2     = len > 1 ? r->curptr[len - 2] : prev1;
+      prev1     = r->curptr[len - 1];
+      r->curptr += len;
+    }
+  }
 
-  return (NULL);
+  return (ch);
 }
 
 
 //
-// 'mxml_parse_element()' - Parse an element for any attributes...
+// 'mxml_stream_new()' - Create a document stream.
+//
+// When `fd` is not `-1` the stream reads from the file descriptor, otherwise
+// it reads using `io_cb` or from memory when `io_cb` is `NULL`.
 //
 
-static int				// O  - Terminating character
-mxml_parse_element(
-    mxml_options_t   *options,		// I - Options
-    mxml_io_cb_t     io_cb,		// I - Read callback function
-    void             *io_cbdata,	// I - Read callback data
-    mxml_node_t      *node,		// I  - Element node
-    _mxml_encoding_t *encoding,		// IO - Encoding
-    int              *line)		// IO - Current line number
+static mxml_stream_t *			// O - Document stream or `NULL` on error
+mxml_stream_new(
+    mxml_options_t *options,		// I - Options
+    int            fd,			// I - File descriptor or `-1`
+    mxml_io_cb_t   io_cb,		// I - Read callback function or `NULL`
+    void           *io_cbdata,		// I - Read callback data
+    const void     *data,		// I - Data in memory
+    size_t         datalen)		// I - Length of data in memory
 {
-  int		ch,			// Current character in file
-		quote;			// Quoting character
-  char		*name,			// Attribute name
-		*value,			// Attribute value
-		*ptr;			// Pointer into name/value
-  size_t	namesize,		// Size of name string
-		valsize;		// Size of value string
+  mxml_stream_t	*stream;		// Document stream
 
 
-  // Initialize the name and value buffers...
-  if ((name = malloc(64)) == NULL)
+  // Create a new stream...
+  if ((stream = calloc(1, sizeof(mxml_stream_t))) == NULL)
   {
-    _mxml_error(options, "Unable to allocate memory for name.");
-    return (EOF);
+    _mxml_error(options, "Unable to allocate document stream.");
+    return (NULL);
   }
 
-  namesize = 64;
+  stream->options = options;
+  stream->fd      = fd;
 
-  if ((value = malloc(64)) == NULL)
+  if (fd >= 0)
   {
-    free(name);
-    _mxml_error(options, "Unable to allocate memory for value.");
-    return (EOF);
+    io_cb     = (mxml_io_cb_t)mxml_read_cb_fd;
+    io_cbdata = &stream->fd;
   }
 
-  valsize = 64;
+  if (!mxml_read_open(&stream->r, options, io_cb, io_cbdata, data, datalen))
+  {
+    free(stream);
+    return (NULL);
+  }
 
-  // Loop until we hit a >, /, ?, or EOF...
-  while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF)
+  if (!mxml_load_init(&stream->l, /*top*/NULL, options))
   {
-    MXML_DEBUG("mxml_parse_element: ch='%c'\n", ch);
+    mxml_read_free(&stream->r);
+    free(stream);
+    return (NULL);
+  }
 
-    // Skip leading whitespace...
-    if (mxml_isspace(ch))
-    {
-      if (ch == '\n')
-        (*line)++;
+  stream->l.stream = true;
 
-      continue;
-    }
+  return (stream);
+}
 
-    // Stop at /, ?, or >...
-    if (ch == '/' || ch == '?')
-    {
-      // Grab the > character and print an error if it isn't there...
-      quote = mxml_getc(options, io_cb, io_cbdata, encoding);
 
-      if (quote != '>')
-      {
-        _mxml_error(options, "Expected '>' after '%c' for element %s, but got '%c' on line %d.", ch, mxmlGetElement(node), quote, *line);
-        goto error;
-      }
+//
+// 'mxml_strtod()' - Convert a string to a double without respect to the locale.
+//
+// Decimal numbers are parsed directly.  The value is computed exactly with a
+// single multiply or divide when the mantissa and power of 10 are exact
+// doubles, or using @code mxml_strtod_lemire@ for up to 19 significant digits.
+// Otherwise the digits and exponent are passed to `strtod` without a decimal
+// point so the result is correctly rounded in any locale.  Other numbers
+// ("inf", "nan", hexadecimal, etc.) are passed to `strtod` as-is.
+//
 
-      break;
-    }
-    else if (ch == '<')
-    {
-      _mxml_error(options, "Bare < in element %s on line %d.", mxmlGetElement(node), *line);
-      goto error;
-    }
-    else if (ch == '>')
-    {
-      break;
-    }
+static double				// O - Real number
+mxml_strtod(const char *buffer,		// I - String
+            char       **bufend)	// O - End of number in string
+{
+  const char	*bufptr = buffer,	// Pointer into buffer
+		*start,			// Start of digits
+		*end,			// End of digits
+		*decptr = NULL;		// Decimal point
+  bool		negative = false,	// Negative number?
+		digits = false,		// Any digits?
+		truncated = false;	// Any significant digits dropped?
+  uint64_t	mantissa = 0;		// Significant digits
+  int		numdigits = 0,		// Number of significant digits
+		fracdigits = 0,		// Number of digits after the decimal point
+		scale = 0,		// Power of 10 for mantissa
+		expval = 0,		// Exponent value
+		exponent;		// Power of 10 for value
+  double	value,			// Value
+		temp_value;		// Value with the next mantissa
+  char		temp[256],		// Temporary buffer
+		*tempbuf,		// Digits and exponent for strtod
+		*tempptr;		// Pointer into temporary buffer
+  size_t	templen;		// Length of temporary buffer
+  static const double powers[] =	// Exact powers of 10
+  {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
 
-    // Read the attribute name...
-    ptr = name;
-    if (!mxml_add_char(options, ch, &ptr, &name, &namesize))
-      goto error;
 
-    if (ch == '\"' || ch == '\'')
+  // Get the sign...
+  if (*bufptr == '-' || *bufptr == '+')
+    negative = *bufptr++ == '-';
+
+  if (*bufptr == '0' && (bufptr[1] == 'x' || bufptr[1] == 'X'))
+    return (strtod(buffer, bufend));
+
+  // Collect up to 19 significant digits...
+  for (start = bufptr; ; bufptr ++)
+  {
+    if (*bufptr >= '0' && *bufptr <= '9')
     {
-      // Name is in quotes, so get a quoted string...
-      quote = ch;
+      digits = true;
 
-      while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF)
-      {
-        if (ch == '&')
-        {
-	  if ((ch = mxml_get_entity(options, io_cb, io_cbdata, encoding, node, line)) == EOF)
-	    goto error;
-	}
-	else if (ch == '\n')
-	{
-	  (*line)++;
-	}
+      if (decptr)
+        fracdigits ++;
 
-	if (!mxml_add_char(options, ch, &ptr, &name, &namesize))
-	  goto error;
+      if (numdigits < 19)
+      {
+        mantissa = mantissa * 10 + (uint64_t)(*bufptr - '0');
 
-	if (ch == quote)
-          break;
+        if (mantissa)
+          numdigits ++;
+        if (decptr)
+          scale --;
       }
-    }
-    else
-    {
-      // Grab an normal, non-quoted name...
-      while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF)
+      else
       {
-	if (mxml_isspace(ch) || ch == '=' || ch == '/' || ch == '>' || ch == '?')
-	{
-	  if (ch == '\n')
-	    (*line)++;
-          break;
-        }
-	else
-	{
-          if (ch == '&')
-          {
-	    if ((ch = mxml_get_entity(options, io_cb, io_cbdata, encoding, node, line)) == EOF)
-	      goto error;
-          }
-
-	  if (!mxml_add_char(options, ch, &ptr, &name, &namesize))
-	    goto error;
-	}
+        if (*bufptr != '0')
+          truncated = true;
+        if (!decptr)
+          scale ++;
       }
     }
+    else if (*bufptr == '.' && !decptr)
+    {
+      decptr = bufptr;
+    }
+    else
+    {
+      break;
+    }
+  }
 
-    *ptr = '\0';
+  if (!digits)
+    return (strtod(buffer, bufend));
 
-    if (mxmlElementGetAttr(node, name))
-    {
-      _mxml_error(options, "Duplicate attribute '%s' in element %s on line %d.", name, mxmlGetElement(node), *line);
-      goto error;
-    }
+  end = bufptr;
 
-    while (ch != EOF && mxml_isspace(ch))
-    {
-      ch = mxml_getc(options, io_cb, io_cbdata, encoding);
+  // Get the exponent, if any...
+  if (*bufptr == 'e' || *bufptr == 'E')
+  {
+    const char	*expptr = bufptr + 1;	// Pointer to exponent
+    bool	expneg = false;		// Negative exponent?
 
-      if (ch == '\n')
-        (*line)++;
-    }
+    if (*expptr == '-' || *expptr == '+')
+      expneg = *expptr++ == '-';
 
-    if (ch == '=')
+    if (*expptr >= '0' && *expptr <= '9')
     {
-      // Read the attribute value...
-      while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF && mxml_isspace(ch))
+      for (; *expptr >= '0' && *expptr <= '9'; expptr ++)
       {
-        if (ch == '\n')
-          (*line)++;
+        if (expval < 100000000)
+          expval = expval * 10 + *expptr - '0';
       }
 
-      if (ch == EOF)
-      {
-        _mxml_error(options, "Missing value for attribute '%s' in element %s on line %d.", name, mxmlGetElement(node), *line);
-        goto error;
-      }
+      if (expneg)
+        expval = -expval;
 
-      if (ch == '\'' || ch == '\"')
-      {
-        // Read quoted value...
-        quote = ch;
-	ptr   = value;
+      bufptr = expptr;
+    }
+  }
 
-        while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF)
-        {
-	  if (ch == quote)
-	  {
-	    break;
-	  }
-	  else
-	  {
-	    if (ch == '&')
-	    {
-	      if ((ch = mxml_get_entity(options, io_cb, io_cbdata, encoding, node, line)) == EOF)
-	        goto error;
-	    }
-	    else if (ch == '\n')
-	    {
-	      (*line)++;
-	    }
+  *bufend = (char *)bufptr;
 
-	    if (!mxml_add_char(options, ch, &ptr, &value, &valsize))
-	      goto error;
-	  }
-	}
+  if (mantissa == 0)
+    return (negative ? -0.0 : 0.0);
 
-        *ptr = '\0';
-      }
-      else
-      {
-        // Read unquoted value...
-	ptr      = value;
-	if (!mxml_add_char(options, ch, &ptr, &value, &valsize))
-	  goto error;
+  exponent = scale + expval;
 
-	while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF)
-	{
-	  if (mxml_isspace(ch) || ch == '=' || ch == '/' || ch == '>')
-	  {
-	    if (ch == '\n')
-	      (*line)++;
+  if (!truncated)
+  {
+#if FLT_EVAL_METHOD == 0 || FLT_EVAL_METHOD == 1
+    // Use exact double arithmetic when the mantissa and power of 10 are exact...
+    if (mantissa <= (UINT64_C(1) << 53) && exponent >= -22 && exponent <= 22)
+    {
+      if (exponent < 0)
+        value = (double)mantissa / powers[-exponent];
+      else
+        value = (double)mantissa * powers[exponent];
 
-            break;
-          }
-	  else
-	  {
-	    if (ch == '&')
-	    {
-	      if ((ch = mxml_get_entity(options, io_cb, io_cbdata, encoding, node, line)) == EOF)
-	        goto error;
-	    }
+      return (negative ? -value : value);
+    }
+#endif // FLT_EVAL_METHOD == 0 || FLT_EVAL_METHOD == 1
 
-	    if (!mxml_add_char(options, ch, &ptr, &value, &valsize))
-	      goto error;
-	  }
-	}
+    if (mxml_strtod_lemire(mantissa, exponent, negative, &value))
+      return (value);
+  }
+  else if (mxml_strtod_lemire(mantissa, exponent, negative, &value) && mxml_strtod_lemire(mantissa + 1, exponent, negative, &temp_value) && value == temp_value)
+  {
+    // The dropped digits don't change the value...
+    return (value);
+  }
 
-        *ptr = '\0';
-      }
+  // Pass the digits and exponent to strtod without a decimal point...
+  templen = (size_t)(end - start) + 16;
 
-      // Set the attribute with the given string value...
-      mxmlElementSetAttr(node, name, value);
-      MXML_DEBUG("mxml_parse_element: %s=\"%s\"\n", name, value);
-    }
-    else
-    {
-      _mxml_error(options, "Missing value for attribute '%s' in element %s on line %d.", name, mxmlGetElement(node), *line);
-      goto error;
-    }
+  if (templen <= sizeof(temp))
+  {
+    tempbuf = temp;
+  }
+  else if ((tempbuf = malloc(templen)) == NULL)
+  {
+    *bufend = (char *)buffer;
+    return (0.0);
+  }
 
-    // Check the end character...
-    if (ch == '/' || ch == '?')
-    {
-      // Grab the > character and print an error if it isn't there...
-      quote = mxml_getc(options, io_cb, io_cbdata, encoding);
+  tempptr = tempbuf;
 
-      if (quote != '>')
-      {
-        _mxml_error(options, "Expected '>' after '%c' for element %s, but got '%c' on line %d.", ch, mxmlGetElement(node), quote, *line);
-        ch = EOF;
-      }
+  if (negative)
+    *tempptr++ = '-';
 
-      break;
-    }
-    else if (ch == '>')
-      break;
+  for (bufptr = start; bufptr < end; bufptr ++)
+  {
+    if (bufptr != decptr)
+      *tempptr++ = *bufptr;
   }
 
-  // Free the name and value buffers and return...
-  free(name);
-  free(value);
-
-  return (ch);
+  snprintf(tempptr, templen - (size_t)(tempptr - tempbuf), "e%d", expval - fracdigits);
 
-  // Common error return point...
-  error:
+  value = strtod(tempbuf, NULL);
 
-  free(name);
-  free(value);
+  if (tempbuf != temp)
+    free(tempbuf);
 
-  return (EOF);
+  return (value);
 }
 
 
 //
-// 'mxml_read_cb_fd()' - Read bytes from a file descriptor.
+// 'mxml_strtod_lemire()' - Convert a decimal mantissa and exponent to a double.
+//
+// This is the Eisel-Lemire algorithm - the normalized mantissa is multiplied by
+// a 128-bit power of 5 and the upper bits of the product give the correctly
+// rounded value.  `false` is returned when the power of 10 is not in the table
+// or the product is too close to halfway between two doubles, in which case a
+// slower conversion must be used.
 //
 
-static size_t				// O - Bytes read
-mxml_read_cb_fd(int    *fd,		// I - File descriptor
-                void   *buffer,		// I - Buffer
-                size_t bytes)		// I - Bytes to read
+static bool				// O - `true` on success, `false` otherwise
+mxml_strtod_lemire(uint64_t mantissa,	// I - Significant digits (non-zero)
+                   int      exponent,	// I - Power of 10
+                   bool     negative,	// I - Negative value?
+                   double   *value)	// O - Value
 {
-#if _WIN32
-  int		rbytes;			// Bytes read
+  const uint64_t *pow5;			// Power of 5
+  uint64_t	upper,			// Upper 64 bits of product
+		lower,			// Lower 64 bits of product
+		hi,			// Upper 64 bits of second product
+		lo,			// Lower 64 bits of second product
+		bits;			// Double bits
+  int		lz,			// Leading zero bits in mantissa
+		binexp;			// Biased binary exponent
 
 
-  rbytes = read(*fd, buffer, bytes);
+  if (exponent < MXML_POW5_MIN || exponent > MXML_POW5_MAX)
+    return (false);
 
+  // Normalize the mantissa and multiply by the power of 5...
+#if defined(__GNUC__) || defined(__clang__)
+  lz = __builtin_clzll(mantissa);
 #else
-  ssize_t	rbytes;			// Bytes read
+  for (lz = 0; !(mantissa & (UINT64_C(1) << (63 - lz))); lz ++);
+#endif // __GNUC__ || __clang__
 
+  mantissa <<= lz;
+  pow5     = mxml_pow5[exponent - MXML_POW5_MIN];
+  lower    = mxml_mul128(mantissa, pow5[0], &upper);
 
-  while ((rbytes = read(*fd, buffer, bytes)) < 0)
+  if ((upper & 0x1ff) == 0x1ff && lower + mantissa < lower)
   {
-    if (errno != EINTR && errno != EAGAIN)
-      break;
+    // Use the lower 64 bits of the power of 5 for more precision...
+    lo    = mxml_mul128(mantissa, pow5[1], &hi);
+    lower += hi;
+
+    if (lower < hi)
+      upper ++;
+
+    if (lower + 1 == 0 && (upper & 0x1ff) == 0x1ff && lo + mantissa < lo)
+      return (false);
   }
-#endif // _WIN32
 
-  if (rbytes < 0)
-    return (0);
-  else
-    return ((size_t)rbytes);
-}
+  // Round to 53 bits, giving up when exactly halfway...
+  bits = upper >> ((upper >> 63) + 9);
+  lz   += (int)(1 ^ (upper >> 63));
 
+  if (lower == 0 && (upper & 0x1ff) == 0 && (bits & 3) == 1)
+    return (false);
 
-//
-// 'mxml_read_cb_file()' - Read bytes from a file pointer.
-//
+  bits += bits & 1;
+  bits >>= 1;
 
-static size_t				// O - Bytes read
-mxml_read_cb_file(FILE   *fp,		// I - File pointer
-                  void   *buffer,	// I - Buffer
-                  size_t bytes)		// I - Bytes to read
-{
-  if (feof(fp))
-    return (0);
-  else
-    return (fread(buffer, 1, bytes, fp));
+  if (bits >= (UINT64_C(1) << 53))
+  {
+    bits = UINT64_C(1) << 52;
+    lz --;
+  }
+
+  // Add the exponent (floor(exponent * log2(10)) + 1023 + 64 - lz) and sign...
+  binexp = (int)((217706 * (int64_t)(exponent + 32768)) >> 16) - 108853 + 1087 - lz;
+
+  if (binexp < 1 || binexp > 2046)
+    return (false);
+
+  bits = (bits & ~(UINT64_C(1) << 52)) | ((uint64_t)binexp << 52);
+
+  if (negative)
+    bits |= UINT64_C(1) << 63;
+
+  memcpy(value, &bits, sizeof(double));
+
+  return (true);
 }
 
 
 //
-// 'mxml_read_cb_string()' - Read bytes from a string.
+// 'mxml_strtol()' - Convert a string to a long integer without respect to the locale.
+//
+// As for `strtol` with a base of `0`, numbers starting with "0x" are
+// hexadecimal, other numbers starting with "0" are octal, and values that are
+// out of range are clamped to `LONG_MIN` or `LONG_MAX`.
 //
 
-static size_t				// O - Bytes read
-mxml_read_cb_string(
-    _mxml_stringbuf_t *sb,		// I - String buffer
-    void              *buffer,		// I - Buffer
-    size_t            bytes)		// I - Bytes to read
+static long				// O - Integer value
+mxml_strtol(const char *buffer,		// I - String
+            char       **bufend)	// O - End of number in string
 {
-  size_t	remaining;		// Remaining bytes in buffer
+  const char	*bufptr = buffer;	// Pointer into buffer
+  bool		negative = false,	// Negative number?
+		digits = false,		// Any digits?
+		overflow = false;	// Value out of range?
+  unsigned	base = 10,		// Number base
+		digit;			// Current digit
+  unsigned long	value = 0,		// Value
+		limit;			// Largest value
 
 
-  if ((remaining = sb->bufsize - (size_t)(sb->bufptr - sb->buffer)) < bytes)
-    bytes = remaining;
+  // Get the sign and base...
+  if (*bufptr == '-' || *bufptr == '+')
+    negative = *bufptr++ == '-';
+  else if (*bufptr < '0' || *bufptr > '9')
+    return (strtol(buffer, bufend, 0));
 
-  if (bytes > 0)
+  if (*bufptr == '0')
   {
-    // Copy bytes from string...
-    memcpy(buffer, sb->bufptr, bytes);
-    sb->bufptr += bytes;
+    if ((bufptr[1] == 'x' || bufptr[1] == 'X') && isxdigit(bufptr[2] & 255))
+    {
+      base   = 16;
+      bufptr += 2;
+    }
+    else
+    {
+      base = 8;
+    }
   }
 
-  return (bytes);
+  limit = negative ? (unsigned long)LONG_MAX + 1 : (unsigned long)LONG_MAX;
+
+  // Convert the digits...
+  for (; ; bufptr ++)
+  {
+    if (*bufptr >= '0' && *bufptr <= '9')
+      digit = (unsigned)(*bufptr - '0');
+    else if (*bufptr >= 'a' && *bufptr <= 'f')
+      digit = (unsigned)(*bufptr - 'a' + 10);
+    else if (*bufptr >= 'A' && *bufptr <= 'F')
+      digit = (unsigned)(*bufptr - 'A' + 10);
+    else
+      break;
+
+    if (digit >= base)
+      break;
+
+    digits = true;
+
+    if (value > (limit - digit) / base)
+      overflow = true;
+    else
+      value = value * base + digit;
+  }
+
+  if (!digits)
+  {
+    *bufend = (char *)buffer;
+    return (0);
+  }
+
+  *bufend = (char *)bufptr;
+
+  if (overflow)
+    return (negative ? LONG_MIN : LONG_MAX);
+  else if (negative && value)
+    return (-(long)(value - 1) - 1);
+  else
+    return ((long)value);
 }
 
 
 //
-// 'mxml_strtod()' - Convert a string to a double without respect to the locale.
+// 'mxml_validate()' - Check for a well-formed XML document.
+//
+// When `fd` is not `-1` the data is read from the file descriptor, otherwise
+// it is read using `io_cb` or from memory when `io_cb` is `NULL`.  The data is
+// parsed with the event callback path of the loader, so no nodes are created.
 //
 
-static double				// O - Real number
-mxml_strtod(mxml_options_t *options,	// I - Options
-            const char     *buffer,	// I - String
-            char           **bufend)	// O - End of number in string
+static bool				// O - `true` if well-formed, `false` otherwise
+mxml_validate(
+    mxml_options_t *options,		// I - Options
+    int            fd,			// I - File descriptor or `-1`
+    mxml_io_cb_t   io_cb,		// I - Read callback function or `NULL`
+    void           *io_cbdata,		// I - Read callback data
+    const void     *data,		// I - Data in memory
+    size_t         datalen,		// I - Length of data in memory
+    int            *errline,		// O - Line number of error or `NULL`
+    size_t         *erroffset)		// O - Byte offset of error or `NULL`
 {
-  const char	*bufptr;		// Pointer into buffer
-  char		temp[64],		// Temporary buffer
-		*tempptr;		// Pointer into temporary buffer
+  _mxml_validate_t	v;		// Validation data
+  _mxml_read_t		r;		// Read buffer
+  _mxml_load_t		l;		// Load data
 
 
-  // See if the locale has a special decimal point string...
-  if (!options || !options->loc)
-    return (strtod(buffer, bufend));
+  // Copy the options and record the first error...
+  memset(&v, 0, sizeof(v));
 
-  // Copy leading sign, numbers, period, and then numbers...
-  tempptr                = temp;
-  temp[sizeof(temp) - 1] = '\0';
-  bufptr                 = buffer;
+  if (options)
+    v.options = *options;
 
-  if (*bufptr == '-' || *bufptr == '+')
-    *tempptr++ = *bufptr++;
+  v.options.sax_cb        = NULL;
+  v.options.event_cb      = (mxml_event_cb_t)mxml_validate_cb;
+  v.options.event_cbdata  = &v;
+  v.options.num_filters   = 0;
+  v.options.lazy          = false;
+  v.options.error_cb      = (mxml_error_cb_t)mxml_validate_error;
+  v.options.error_cbdata  = &v;
+  v.user_options          = options;
+  v.fd                    = fd;
+
+  if (errline)
+    *errline = 0;
+  if (erroffset)
+    *erroffset = 0;
 
-  while (*bufptr && isdigit(*bufptr & 255))
+  if (fd >= 0)
   {
-    if (tempptr < (temp + sizeof(temp) - 1))
-    {
-      *tempptr++ = *bufptr++;
-    }
-    else
-    {
-      *bufend = (char *)bufptr;
-      return (0.0);
-    }
+    io_cb     = (mxml_io_cb_t)mxml_read_cb_fd;
+    io_cbdata = &v.fd;
   }
 
-  if (*bufptr == '.')
+  if (!mxml_read_open(&r, &v.options, io_cb, io_cbdata, data, datalen))
+    return (false);
+
+  if (!mxml_load_init(&l, /*top*/NULL, &v.options))
   {
-    // Convert decimal point to locale equivalent...
-    size_t	declen = strlen(options->loc->decimal_point);
-					// Length of decimal point
-    bufptr ++;
+    mxml_read_free(&r);
+    return (false);
+  }
 
-    if (declen <= (sizeof(temp) - (size_t)(tempptr - temp)))
-    {
-      memcpy(tempptr, options->loc->decimal_point, declen);
-      tempptr += declen;
-    }
+  // Parse the data, checking attributes and close tags...
+  v.r           = &r;
+  v.l           = &l;
+  l.check_attrs = true;
+
+  if (!mxml_load_parse(&l, &v.options, &r))
+  {
+    // Some errors stop loading without a message...
+    if (!v.error && v.text)
+      _mxml_error(&v.options, "Text outside the root element on line %d.", l.line);
+    else if (!v.error)
+      _mxml_error(&v.options, "Invalid XML data on line %d.", l.line);
+  }
+  else if (!v.error)
+  {
+    if (r.error)
+      _mxml_error(&v.options, "%s", r.error);
+    else if (l.stacklen == 0 && !mxml_validate_space(l.buffer, l.buflen))
+      _mxml_error(&v.options, "Text outside the root element on line %d.", l.line);
     else
-    {
-      *bufend = (char *)bufptr;
-      return (0.0);
-    }
+      mxml_load_finish(&l, &v.options);
+
+    if (!v.error && !l.root)
+      _mxml_error(&v.options, "Missing root element.");
   }
 
-  // Copy any remaining characters...
-  while (*bufptr && isdigit(*bufptr & 255))
+  if (v.error)
   {
-    if (tempptr < (temp + sizeof(temp) - 1))
-      *tempptr++ = *bufptr++;
-    else
-      break;
+    if (errline)
+      *errline = l.line;
+    if (erroffset)
+      *erroffset = v.offset;
   }
 
-  *bufend = (char *)bufptr;
+  mxml_load_free(&l);
+  mxml_read_free(&r);
+
+  return (!v.error);
+}
 
-  if (*bufptr)
-    return (0.0);
 
-  // Nul-terminate the temporary string and convert the string...
-  *tempptr = '\0';
+//
+// 'mxml_validate_cb()' - Check each event while checking a document.
+//
+// Only whitespace, comments, and processing instructions are allowed outside
+// the root element.
+//
+
+static bool				// O - `true` to continue, `false` to stop
+mxml_validate_cb(
+    _mxml_validate_t *v,		// I - Validation data
+    mxml_sax_event_t event,		// I - Event
+    const char       *data,		// I - Name or text
+    size_t           datalen,		// I - Length of name or text
+    mxml_attrs_t     *attrs)		// I - Attributes (unused)
+{
+  (void)attrs;
+
+  if (v->l->stacklen == 0 && ((event == MXML_SAX_EVENT_DATA && !mxml_validate_space(data, datalen)) || event == MXML_SAX_EVENT_CDATA))
+  {
+    v->text = true;
+    return (false);
+  }
+
+  return (true);
+}
+
+
+//
+// 'mxml_validate_error()' - Record and report the first error while checking a document.
+//
 
-  return (strtod(temp, NULL));
+static void
+mxml_validate_error(
+    _mxml_validate_t *v,		// I - Validation data
+    const char       *message)		// I - Error message
+{
+  if (v->error)
+    return;
+
+  v->error = true;
+
+  if (v->r)
+    v->offset = v->r->error ? v->r->erroffset : v->r->offset + (size_t)(mxml_read_tell(v->r) - v->r->buffer);
+
+  _mxml_error(v->user_options, "%s", message);
+}
+
+
+//
+// 'mxml_validate_space()' - Check whether text only contains whitespace.
+//
+
+static bool				// O - `true` if only whitespace, `false` otherwise
+mxml_validate_space(
+    const char *data,			// I - Text
+    size_t     datalen)			// I - Length of text
+{
+  for (; datalen > 0; data ++, datalen --)
+  {
+    if (!mxml_isspace(*data))
+      return (false);
+  }
+
+  return (true);
 }
 
 
@@ -2050,7 +7996,7 @@ mxml_write_node(
 	    }
 	  }
 
-	  col = mxml_write_string(current->child ? ">" : "/>", io_cb, io_cbdata, /*use_entities*/false, col);
+	  col = mxml_write_string(mxmlGetFirstChild(current) ? ">" : "/>", io_cb, io_cbdata, /*use_entities*/false, col);
 	  col = mxml_write_ws(current, options, io_cb, io_cbdata, MXML_WS_AFTER_OPEN, col);
 	  break;
 
@@ -67,7 +67,7 @@ mxmlGetCustom(mxml_node_t *node)	// I - Node to get
   // Return the custom value...
   if (node->type == MXML_TYPE_CUSTOM)
     return (node->value.custom.data);
-  else if (node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_CUSTOM)
+  else if (node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_CUSTOM)
     return (node->child->value.custom.data);
   else
     return (NULL);
@@ -141,6 +141,9 @@ mxmlGetElement(mxml_node_t *node)	// I - Node to get
 mxml_node_t *				// O - First child or `NULL`
 mxmlGetFirstChild(mxml_node_t *node)	// I - Node to get
 {
+  // Load the children of a lazily loaded element as needed...
+  _mxml_lazy_load(node);
+
   // Return the first child node...
   return (node ? node->child : NULL);
 }
@@ -164,7 +167,7 @@ mxmlGetInteger(mxml_node_t *node)	// I - Node to get
   // Return the integer value...
   if (node->type == MXML_TYPE_INTEGER)
     return (node->value.integer);
-  else if (node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_INTEGER)
+  else if (node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_INTEGER)
     return (node->child->value.integer);
   else
     return (0);
@@ -181,6 +184,9 @@ mxmlGetInteger(mxml_node_t *node)	// I - Node to get
 mxml_node_t *				// O - Last child or `NULL`
 mxmlGetLastChild(mxml_node_t *node)	// I - Node to get
 {
+  // Load the children of a lazily loaded element as needed...
+  _mxml_lazy_load(node);
+
   return (node ? node->last_child : NULL);
 }
 
@@ -216,7 +222,7 @@ mxmlGetOpaque(mxml_node_t *node)	// I - Node to get
   // Return the opaque value...
   if (node->type == MXML_TYPE_OPAQUE)
     return (node->value.opaque);
-  else if (node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_OPAQUE)
+  else if (node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_OPAQUE)
     return (node->child->value.opaque);
   else
     return (NULL);
@@ -267,7 +273,7 @@ mxmlGetReal(mxml_node_t *node)		// I - Node to get
   // Return the real value...
   if (node->type == MXML_TYPE_REAL)
     return (node->value.real);
-  else if (node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_REAL)
+  else if (node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_REAL)
     return (node->child->value.real);
   else
     return (0.0);
@@ -310,7 +316,7 @@ mxmlGetText(mxml_node_t *node,		// I - Node to get
 
     return (node->value.text.string);
   }
-  else if (node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_TEXT)
+  else if (node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_TEXT)
   {
     if (whitespace)
       *whitespace = node->child->value.text.whitespace;
@@ -359,6 +365,7 @@ mxmlGetUserData(mxml_node_t *node)	// I - Node to get
   if (!node)
     return (NULL);
 
-  // Return the user data pointer...
-  return (node->user_data);
+  // Return the user data pointer, which holds the source of the children of a
+  // lazily loaded element...
+  return (node->lazy ? NULL : node->user_data);
 }
@@ -42,6 +42,9 @@ mxmlAdd(mxml_node_t *parent,		// I - Parent node
   if (!parent || !node)
     return;
 
+  // Load the children of a lazily loaded parent first...
+  _mxml_lazy_load(parent);
+
   // Remove the node from any existing parent...
   if (node->parent)
     mxmlRemove(node);
@@ -849,6 +852,50 @@ mxmlRetain(mxml_node_t *node)		// I - Node
 }
 
 
+//
+// 'mxmlSkipChildren()' - Skip the contents of an element from a SAX callback.
+//
+// This function tells the loader to skip the contents of the element that was
+// just opened.  It is called by a SAX callback when handling the
+// `MXML_SAX_EVENT_ELEMENT_OPEN` event for an element whose contents are not
+// needed.  The contents are skipped without creating any nodes or reporting any
+// events, and the next event is the `MXML_SAX_EVENT_ELEMENT_CLOSE` event for the
+// element.
+//
+
+bool					// O - `true` on success, `false` on error
+mxmlSkipChildren(mxml_node_t *node)	// I - Element node
+{
+  if (!node || node->type != MXML_TYPE_ELEMENT)
+    return (false);
+
+  node->skip = true;
+
+  return (true);
+}
+
+
+//
+// '_mxml_new_element()' - Create a new element node with a shared name.
+//
+
+mxml_node_t *				// O - New node
+_mxml_new_element(mxml_node_t  *parent,	// I - Parent node or `NULL`
+                  _mxml_name_t *name)	// I - Shared name
+{
+  mxml_node_t	*node;			// New node
+
+
+  if ((node = mxml_new(parent, MXML_TYPE_ELEMENT)) != NULL)
+  {
+    node->value.element.name = _mxml_name_retain(name);
+    node->shared_name        = true;
+  }
+
+  return (node);
+}
+
+
 //
 // 'mxml_free()' - Free the memory used by a node.
 //
@@ -876,7 +923,10 @@ mxml_free(mxml_node_t *node)		// I - Node
 	_mxml_strfree(node->value.directive);
         break;
     case MXML_TYPE_ELEMENT :
-	_mxml_strfree(node->value.element.name);
+        if (node->shared_name)
+	  _mxml_name_release(node->value.element.name);
+	else
+	  _mxml_strfree(node->value.element.name);
 
 	if (node->value.element.num_attrs)
 	{
@@ -888,6 +938,9 @@ mxml_free(mxml_node_t *node)		// I - Node
 
           free(node->value.element.attrs);
 	}
+
+        if (node->lazy)
+          _mxml_lazy_free(node);
         break;
     case MXML_TYPE_INTEGER :
        // Nothing to do
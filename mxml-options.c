@@ -20,6 +20,12 @@ void
 mxmlOptionsDelete(
     mxml_options_t *options)		// I - Options
 {
+  if (options)
+  {
+    mxmlOptionsSetFilter(options, 0, NULL);
+    mxmlOptionsSetTypeTable(options, 0, NULL, NULL);
+  }
+
   free(options);
 }
 
@@ -28,12 +34,15 @@ mxmlOptionsDelete(
 // 'mxmlOptionsNew()' - Allocate load/save options.
 //
 // This function creates a new set of load/save options to use with the
-// @link mxmlLoadFd@, @link mxmlLoadFile@, @link mxmlLoadFilename@,
-// @link mxmlLoadIO@, @link mxmlLoadString@, @link mxmlSaveAllocString@,
+// @link mxmlLoadBuffer@, @link mxmlLoadFd@, @link mxmlLoadFile@,
+// @link mxmlLoadFilename@, @link mxmlLoadFilenames@, @link mxmlLoadIO@,
+// @link mxmlLoadString@, @link mxmlParserNew@, @link mxmlSaveAllocString@,
 // @link mxmlSaveFd@, @link mxmlSaveFile@, @link mxmlSaveFilename@,
-// @link mxmlSaveIO@, and @link mxmlSaveString@ functions.  Options can be
-// reused for multiple calls to these functions and should be freed using the
-// @link mxmlOptionsDelete@ function.
+// @link mxmlSaveIO@, @link mxmlSaveString@, @link mxmlStreamNewBuffer@,
+// @link mxmlStreamNewFd@, @link mxmlStreamNewFile@, and
+// @link mxmlStreamNewIO@ functions.  Options can be reused for multiple calls
+// to these functions and should be freed using the @link mxmlOptionsDelete@
+// function.
 //
 // The default load/save options load values using the constant type
 // `MXML_TYPE_TEXT` and save XML data with a wrap margin of 72 columns.
@@ -63,6 +72,7 @@ mxmlOptionsNew(void)
   if ((options = (mxml_options_t *)calloc(1, sizeof(mxml_options_t))) != NULL)
   {
     // Set default values...
+    options->threads    = 1;
     options->type_value = MXML_TYPE_TEXT;
     options->wrap       = 72;
 
@@ -79,6 +89,34 @@ mxmlOptionsNew(void)
 }
 
 
+//
+// 'mxmlOptionsSetCompression()' - Set the decompression of loaded XML data.
+//
+// This function sets how compressed XML data is handled when loading.  The
+// `compression` argument is one of the following:
+//
+// - `MXML_COMPRESSION_AUTO`: Data starting with a gzip header is decompressed
+//   (the default).
+// - `MXML_COMPRESSION_NONE`: Data is never decompressed.
+// - `MXML_COMPRESSION_GZIP`: Data is always decompressed, accepting either a
+//   gzip or zlib header.
+//
+// Compressed data is decompressed in large blocks as it is parsed, so the
+// whole document never needs to be decompressed into memory.  Decompression
+// is not available for the @link mxmlParserNew@ push parser or when Mini-XML
+// is built without zlib, in which case loading compressed data fails.
+//
+
+void
+mxmlOptionsSetCompression(
+    mxml_options_t     *options,	// I - Options
+    mxml_compression_t compression)	// I - Decompression of loaded data
+{
+  if (options)
+    options->compression = compression;
+}
+
+
 //
 // 'mxmlOptionsSetCustomCallbacks()' - Set the custom data callbacks.
 //
@@ -259,6 +297,189 @@ mxmlOptionsSetErrorCallback(
 }
 
 
+//
+// 'mxmlOptionsSetEventCallback()' - Set the event callback to use when reading XML data.
+//
+// This function sets a lightweight alternative to the SAX callback that does
+// not create any nodes.  The callback `cb` receives the callback data `cbdata`,
+// the event, a pointer to the event data and its length in bytes, and the
+// attributes of the element for `MXML_SAX_EVENT_ELEMENT_OPEN` events:
+//
+// ```c
+// bool
+// event_cb(void *cbdata, mxml_sax_event_t event,
+//          const char *data, size_t datalen,
+//          mxml_attrs_t *attrs)
+// {
+//   const char *name, *value;
+//
+//   if (event == MXML_SAX_EVENT_ELEMENT_OPEN)
+//   {
+//     while (mxmlAttrsNext(attrs, &name, NULL, &value, NULL))
+//       ... do something with the attribute ...
+//   }
+//
+//   /* Continue processing... */
+//   return (true);
+// }
+// ```
+//
+// The data is the element name for `MXML_SAX_EVENT_ELEMENT_OPEN` and
+// `MXML_SAX_EVENT_ELEMENT_CLOSE` events, the text with any entities decoded for
+// `MXML_SAX_EVENT_DATA` events, and the contents of the comment, CDATA,
+// declaration, or processing instruction for the other events.  Text is
+// reported as it appears between tags, including any whitespace between
+// elements.  The data and attributes are nul-terminated strings that are only
+// valid until the callback returns, and attributes are not checked for
+// duplicates.
+//
+// The callback returns `true` to continue processing or `false` to stop.  The
+// load functions return `NULL` (or the top node) since no nodes are created,
+// and the type, SAX, filter, lazy, and thread options are not used.
+//
+
+void
+mxmlOptionsSetEventCallback(
+    mxml_options_t  *options,		// I - Options
+    mxml_event_cb_t cb,			// I - Event callback function
+    void            *cbdata)		// I - Event callback data
+{
+  if (options)
+  {
+    options->event_cb     = cb;
+    options->event_cbdata = cbdata;
+  }
+}
+
+
+//
+// 'mxmlOptionsSetFilter()' - Set the paths of the elements to load.
+//
+// This function sets the paths of the elements to load from XML data.  The
+// paths use the same syntax as the @link mxmlFindPath@ function, starting with
+// the name of the root element, for example "feed/order/item" or "*/item".
+// Only the matching elements and their contents are loaded, along with the
+// elements that contain them and any nodes outside the root element.  Other
+// elements are skipped without being parsed, so their contents are only checked
+// for balanced markup.  The root element is always loaded.
+//
+// Pass `0` and `NULL` to load all elements.  The @link mxmlOptionsSetLazy@
+// and @link mxmlOptionsSetThreads@ options are ignored when filtering.  When a
+// SAX callback is set, an element that might contain matching elements is
+// reported even if it does not, since it is reported before its contents are
+// seen.
+//
+
+bool					// O - `true` on success, `false` on error
+mxmlOptionsSetFilter(
+    mxml_options_t    *options,		// I - Options
+    size_t            num_paths,	// I - Number of paths
+    const char * const *paths)		// I - Paths to load
+{
+  size_t	i;			// Looping var
+  char		**filters = NULL;	// Copy of paths
+
+
+  // Range check input...
+  if (!options || (num_paths > 0 && !paths))
+    return (false);
+
+  // Copy the paths...
+  if (num_paths > 0)
+  {
+    if ((filters = calloc(num_paths, sizeof(char *))) == NULL)
+      return (false);
+
+    for (i = 0; i < num_paths; i ++)
+    {
+      if (!paths[i] || (filters[i] = strdup(paths[i])) == NULL)
+      {
+        while (i > 0)
+          free(filters[-- i]);
+
+        free(filters);
+        return (false);
+      }
+    }
+  }
+
+  // Free any old paths and save the new ones...
+  for (i = 0; i < options->num_filters; i ++)
+    free(options->filters[i]);
+
+  free(options->filters);
+
+  options->num_filters = num_paths;
+  options->filters     = filters;
+
+  return (true);
+}
+
+
+//
+// 'mxmlOptionsSetLazy()' - Set whether to load element contents when first accessed.
+//
+// This function sets whether the @link mxmlLoadBuffer@, @link mxmlLoadFilename@,
+// and @link mxmlLoadString@ functions skip over the contents of each element
+// and load them the first time they are accessed, for example by calling
+// @link mxmlGetFirstChild@, @link mxmlFindElement@, or @link mxmlWalkNext@.
+// Loading a large document then only checks the structure of the markup, and
+// the time and memory used grow with the parts of the document that are
+// actually used.  The attributes of an element are always loaded with it.
+//
+// The buffer or string must not be changed or freed until the loaded nodes are
+// deleted, and files loaded by @link mxmlLoadFilename@ stay memory-mapped.  The
+// options are copied, so any callbacks and callback data must stay valid until
+// the loaded nodes are deleted.  Errors in the contents of an element are
+// reported when they are loaded, leaving the element without children.  Since
+// accessing a node can change the tree, nodes that are loaded lazily must not
+// be used by multiple threads at the same time.
+//
+// Compressed data, UTF-16 data, data loaded using a SAX callback, and data read
+// from a file descriptor, `FILE` pointer, or read callback are always loaded
+// completely.
+//
+
+void
+mxmlOptionsSetLazy(
+    mxml_options_t *options,		// I - Options
+    bool           lazy)		// I - `true` to load element contents when first accessed, `false` to load everything
+{
+  if (options)
+    options->lazy = lazy;
+}
+
+
+//
+// 'mxmlOptionsSetReadAhead()' - Set whether to read data from a separate thread.
+//
+// This function sets whether the @link mxmlLoadFd@, @link mxmlLoadFile@,
+// @link mxmlLoadFilename@, and @link mxmlLoadIO@ functions read data from a
+// separate thread while parsing.  The thread fills one buffer while the parser
+// consumes the other, which makes loading from slow storage such as a network
+// filesystem take about as long as the slower of reading and parsing instead
+// of both added together.  Files loaded by @link mxmlLoadFilename@ are read
+// rather than memory-mapped when reading ahead.
+//
+// The read callback of @link mxmlLoadIO@ is called from the read-ahead thread,
+// one call at a time.  The load functions stop the thread before returning: a
+// read from a file descriptor that is waiting for data is interrupted, while a
+// read callback that is in progress is allowed to finish.  `FILE` pointers that
+// are not regular files, such as pipes, are read without a separate thread.
+// Reading ahead is ignored when Mini-XML is built without POSIX threads
+// support.
+//
+
+void
+mxmlOptionsSetReadAhead(
+    mxml_options_t *options,		// I - Options
+    bool           readahead)		// I - `true` to read from a separate thread, `false` otherwise
+{
+  if (options)
+    options->readahead = readahead;
+}
+
+
 //
 // 'mxmlOptionsSetSAXCallback()' - Set the SAX callback to use when reading XML data.
 //
@@ -295,6 +516,11 @@ mxmlOptionsSetErrorCallback(
 // are released after they are processed.  The SAX callback can *retain* the node
 // using the [mxmlRetain](@@) function.
 //
+// When handling the `MXML_SAX_EVENT_ELEMENT_OPEN` event, the SAX callback can
+// skip the contents of the element using the [mxmlSkipChildren](@@) function.
+// The contents are not loaded or reported, and the next event is the
+// `MXML_SAX_EVENT_ELEMENT_CLOSE` event for the element.
+//
 
 void
 mxmlOptionsSetSAXCallback(
@@ -310,6 +536,39 @@ mxmlOptionsSetSAXCallback(
 }
 
 
+//
+// 'mxmlOptionsSetThreads()' - Set the number of threads for loading large documents.
+//
+// This function sets the number of threads used by the @link mxmlLoadBuffer@,
+// @link mxmlLoadFilename@, and @link mxmlLoadString@ functions to load large
+// documents.  The children of the root element are split into chunks between
+// elements, the chunks are loaded by separate threads, and the loaded nodes are
+// added to the root element in document order.  The resulting XML node tree
+// and any errors, including their line numbers, are the same as loading the
+// document using a single thread.  If `nthreads` is `0`, one thread is used for
+// each available processor.  The default is `1` thread.
+//
+// Since chunks are loaded by multiple threads at the same time, the custom,
+// entity, and type callbacks must be thread-safe, and the type callback gets
+// a copy of the root element for its children.  The string copy/free callbacks
+// of the calling thread (see @link mxmlSetStringCallbacks@) are used for all
+// chunks and must also be thread-safe.
+//
+// Documents are loaded using a single thread when a SAX callback is set, when
+// the data is compressed, when the document is smaller than a few megabytes,
+// or when Mini-XML is built without POSIX threads support.
+//
+
+void
+mxmlOptionsSetThreads(
+    mxml_options_t *options,		// I - Options
+    size_t         nthreads)		// I - Number of threads or `0` for automatic
+{
+  if (options)
+    options->threads = nthreads;
+}
+
+
 //
 // 'mxmlOptionsSetTypeCallback()' - Set the type callback for child/value nodes.
 //
@@ -360,6 +619,52 @@ mxmlOptionsSetTypeCallback(
 }
 
 
+//
+// 'mxmlOptionsSetTypeTable()' - Set the types to use for the child/value nodes of named elements.
+//
+// This function sets a table of value node types for element names.  The
+// `num_types` element names in `names` are copied along with the types in
+// `types`, and later entries replace earlier ones with the same name.  When
+// loading, the type for the children of each element is found in the table
+// using a hash lookup, and the type callback or constant type is only used for
+// elements that are not listed, for example:
+//
+// ```c
+// static const char * const names[] = { "count", "price", "script" };
+// static const mxml_type_t types[] = { MXML_TYPE_INTEGER, MXML_TYPE_REAL, MXML_TYPE_OPAQUE };
+//
+// mxmlOptionsSetTypeTable(options, 3, names, types);
+// ```
+//
+// Pass `0` and `NULL` to remove the table.
+//
+
+bool					// O - `true` on success, `false` on error
+mxmlOptionsSetTypeTable(
+    mxml_options_t    *options,		// I - Options
+    size_t            num_types,	// I - Number of element names
+    const char * const *names,		// I - Element names
+    const mxml_type_t *types)		// I - Value node types
+{
+  _mxml_types_t	*table = NULL;		// New table
+
+
+  // Range check input...
+  if (!options || (num_types > 0 && (!names || !types)))
+    return (false);
+
+  // Create the new table and replace any old one...
+  if (num_types > 0 && (table = _mxml_types_new(num_types, names, types)) == NULL)
+    return (false);
+
+  _mxml_types_release(options->types);
+
+  options->types = table;
+
+  return (true);
+}
+
+
 //
 // 'mxmlOptionsSetTypeValue()' - Set the type to use for all child/value nodes.
 //
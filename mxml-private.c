@@ -10,6 +10,13 @@
 //
 
 #include "mxml-private.h"
+#ifdef _MSC_VER
+#  include <intrin.h>
+#elif !defined(__GNUC__) && defined(HAVE_PTHREAD_H)
+#  include <pthread.h>
+static pthread_mutex_t	_mxml_refs_mutex = PTHREAD_MUTEX_INITIALIZER;
+					// Mutex for shared name and type table reference counts
+#endif // _MSC_VER
 
 
 //
@@ -79,6 +86,91 @@ mxmlSetStringCallbacks(
 }
 
 
+//
+// '_mxml_name_new()' - Create a shared element name.
+//
+// Shared names are used when loading XML data without string callbacks so
+// that elements with the same name can use a single copy of the name.  The
+// new name has a reference count of 1.
+//
+
+_mxml_name_t *				// O - Shared name or `NULL` on error
+_mxml_name_new(const char *s)		// I - Name string
+{
+  _mxml_name_t	*name;			// Shared name
+  size_t	len = strlen(s);	// Length of name string
+
+
+  if ((name = malloc(sizeof(_mxml_name_t) + len)) != NULL)
+  {
+    name->refs = 1;
+    memcpy(name->name, s, len + 1);
+  }
+
+  return (name);
+}
+
+
+//
+// '_mxml_name_release()' - Release a reference to a shared element name.
+//
+// The name is freed when the last reference is released.  Since the elements
+// using a name can be deleted from different threads, the reference count is
+// updated atomically.
+//
+
+void
+_mxml_name_release(char *s)		// I - Shared name string
+{
+  _mxml_name_t	*name;			// Shared name
+  long		refs;			// New reference count
+
+
+  if (!s)
+    return;
+
+  name = (_mxml_name_t *)(s - offsetof(_mxml_name_t, name));
+
+#ifdef _MSC_VER
+  refs = _InterlockedDecrement(&name->refs);
+#elif defined(__GNUC__)
+  refs = __atomic_sub_fetch(&name->refs, 1, __ATOMIC_ACQ_REL);
+#elif defined(HAVE_PTHREAD_H)
+  pthread_mutex_lock(&_mxml_refs_mutex);
+  refs = -- name->refs;
+  pthread_mutex_unlock(&_mxml_refs_mutex);
+#else
+  refs = -- name->refs;
+#endif // _MSC_VER
+
+  if (refs == 0)
+    free(name);
+}
+
+
+//
+// '_mxml_name_retain()' - Add a reference to a shared element name.
+//
+
+char *					// O - Name string
+_mxml_name_retain(_mxml_name_t *name)	// I - Shared name
+{
+#ifdef _MSC_VER
+  _InterlockedIncrement(&name->refs);
+#elif defined(__GNUC__)
+  __atomic_add_fetch(&name->refs, 1, __ATOMIC_RELAXED);
+#elif defined(HAVE_PTHREAD_H)
+  pthread_mutex_lock(&_mxml_refs_mutex);
+  name->refs ++;
+  pthread_mutex_unlock(&_mxml_refs_mutex);
+#else
+  name->refs ++;
+#endif // _MSC_VER
+
+  return (name->name);
+}
+
+
 //
 // '_mxml_strcopy()' - Copy a string.
 //
@@ -121,6 +213,75 @@ _mxml_strfree(char *s)			// I - String
 }
 
 
+//
+// '_mxml_types_release()' - Release a reference to a table of value types.
+//
+// The table is freed when the last reference is released.  Since lazy loading
+// can retain a table from different threads, the reference count is updated
+// atomically.
+//
+
+void
+_mxml_types_release(_mxml_types_t *t)	// I - Value types or `NULL`
+{
+  size_t	i;			// Looping var
+  long		refs;			// New reference count
+
+
+  if (!t)
+    return;
+
+#ifdef _MSC_VER
+  refs = _InterlockedDecrement(&t->refs);
+#elif defined(__GNUC__)
+  refs = __atomic_sub_fetch(&t->refs, 1, __ATOMIC_ACQ_REL);
+#elif defined(HAVE_PTHREAD_H)
+  pthread_mutex_lock(&_mxml_refs_mutex);
+  refs = -- t->refs;
+  pthread_mutex_unlock(&_mxml_refs_mutex);
+#else
+  refs = -- t->refs;
+#endif // _MSC_VER
+
+  if (refs > 0)
+    return;
+
+  if (t->names)
+  {
+    for (i = 0; i < t->size; i ++)
+      free(t->names[i]);
+
+    free(t->names);
+  }
+
+  free(t->types);
+  free(t);
+}
+
+
+//
+// '_mxml_types_retain()' - Add a reference to a table of value types.
+//
+
+_mxml_types_t *				// O - Value types
+_mxml_types_retain(_mxml_types_t *t)	// I - Value types
+{
+#ifdef _MSC_VER
+  _InterlockedIncrement(&t->refs);
+#elif defined(__GNUC__)
+  __atomic_add_fetch(&t->refs, 1, __ATOMIC_RELAXED);
+#elif defined(HAVE_PTHREAD_H)
+  pthread_mutex_lock(&_mxml_refs_mutex);
+  t->refs ++;
+  pthread_mutex_unlock(&_mxml_refs_mutex);
+#else
+  t->refs ++;
+#endif // _MSC_VER
+
+  return (t);
+}
+
+
 #ifdef HAVE_PTHREAD_H			// POSIX threading
 #  include <pthread.h>
 
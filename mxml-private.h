@@ -30,6 +30,7 @@
 
 #  include "mxml.h"
 #  include <stdarg.h>
+#  include <stddef.h>
 #  include <locale.h>
 
 #  if _WIN32
@@ -44,6 +45,7 @@
 //
 #    include <io.h>
 #    define close	_close
+#    define lseek	_lseek
 #    define open	_open
 #    define read	_read
 #    define snprintf 	_snprintf
@@ -71,6 +73,15 @@
 #  ifndef MXML_ALLOC_SIZE
 #    define MXML_ALLOC_SIZE	16	// Allocation increment
 #  endif // !MXML_ALLOC_SIZE
+#  ifndef MXML_ATTR_HASH
+#    define MXML_ATTR_HASH	16	// Number of attributes before hashing names while loading
+#  endif // !MXML_ATTR_HASH
+#  ifndef MXML_CHUNK_SIZE
+#    define MXML_CHUNK_SIZE	1048576	// Minimum chunk size for loading on multiple threads
+#  endif // !MXML_CHUNK_SIZE
+#  ifndef MXML_READ_SIZE
+#    define MXML_READ_SIZE	65536	// Read buffer size
+#  endif // !MXML_READ_SIZE
 #  define MXML_TAB		8	// Tabs every N columns
 
 
@@ -91,6 +102,20 @@ typedef struct _mxml_element_s		// An XML element value.
   _mxml_attr_t		*attrs;		// Attributes
 } _mxml_element_t;
 
+typedef struct _mxml_name_s		// A shared element name.
+{
+  long			refs;		// Reference count
+  char			name[1];	// Name string
+} _mxml_name_t;
+
+typedef struct _mxml_types_s		// A table of value types for element names.
+{
+  long			refs;		// Reference count
+  size_t		size;		// Number of slots (power of 2)
+  char			**names;	// Element names or `NULL` for empty slots
+  mxml_type_t		*types;		// Value types
+} _mxml_types_t;
+
 typedef struct _mxml_text_s		// An XML text value.
 {
   bool			whitespace;	// Leading whitespace?
@@ -121,6 +146,9 @@ typedef union _mxml_value_u		// An XML node value.
 struct _mxml_node_s			// An XML node.
 {
   mxml_type_t		type;		// Node type
+  bool			shared_name;	// Is the element name a shared @code _mxml_name_t@ string?
+  bool			lazy;		// Are the element contents loaded later? (`user_data` holds the source range)
+  bool			skip;		// Skip the element contents? (set by the SAX callback)
   struct _mxml_node_s	*next;		// Next node under same parent
   struct _mxml_node_s	*prev;		// Previous node under same parent
   struct _mxml_node_s	*parent;	// Parent node
@@ -138,6 +166,12 @@ typedef struct _mxml_global_s		// Global, per-thread data
   void			*str_cbdata;	// String callback data
 } _mxml_global_t;
 
+struct _mxml_attrs_s			// Element attributes for the event callback
+{
+  const char		*ptr,		// Next name and value strings
+			*end;		// End of strings
+};
+
 struct _mxml_index_s			// An XML node index.
 {
   char			*attr;		// Attribute used for indexing or NULL
@@ -151,6 +185,9 @@ struct _mxml_options_s			// XML options
 {
   struct lconv		*loc;		// Locale data
   size_t		loc_declen;	// Length of decimal point string
+  mxml_compression_t	compression;	// Decompression of loaded data
+  bool			lazy;		// Load element contents when first accessed?
+  bool			readahead;	// Read from a separate thread?
   mxml_custload_cb_t	custload_cb;	// Custom load callback function
   mxml_custsave_cb_t	custsave_cb;	// Custom save callback function
   void			*cust_cbdata;	// Custom callback data
@@ -158,11 +195,17 @@ struct _mxml_options_s			// XML options
   void			*entity_cbdata;	// Entity callback data
   mxml_error_cb_t	error_cb;	// Error callback function
   void			*error_cbdata;	// Error callback data
+  mxml_event_cb_t	event_cb;	// Event callback function
+  void			*event_cbdata;	// Event callback data
+  size_t		num_filters;	// Number of filter paths
+  char			**filters;	// Filter paths
   mxml_sax_cb_t		sax_cb;		// SAX callback function
   void			*sax_cbdata;	// SAX callback data
+  size_t		threads;	// Number of threads for loading large documents
   mxml_type_cb_t	type_cb;	// Type callback function
   void			*type_cbdata;	// Type callback data
   mxml_type_t		type_value;	// Fixed type value (if no type callback)
+  _mxml_types_t		*types;		// Value types for element names or `NULL`
   int			wrap;		// Wrap margin
   mxml_ws_cb_t		ws_cb;		// Whitespace callback function
   void			*ws_cbdata;	// Whitespace callback data
@@ -173,11 +216,21 @@ struct _mxml_options_s			// XML options
 // Private functions...
 //
 
+extern bool		_mxml_add_attr(mxml_node_t *node, const char *name, const char *value);
 extern _mxml_global_t	*_mxml_global(void);
 extern const char	*_mxml_entity_string(int ch);
 extern int		_mxml_entity_value(mxml_options_t *options, const char *name);
 extern void		_mxml_error(mxml_options_t *options, const char *format, ...) MXML_FORMAT(2,3);
+extern void		_mxml_lazy_free(mxml_node_t *node);
+extern void		_mxml_lazy_load(mxml_node_t *node);
+extern _mxml_name_t	*_mxml_name_new(const char *s);
+extern void		_mxml_name_release(char *s);
+extern char		*_mxml_name_retain(_mxml_name_t *name);
+extern mxml_node_t	*_mxml_new_element(mxml_node_t *parent, _mxml_name_t *name);
 extern char		*_mxml_strcopy(const char *s);
 extern void		_mxml_strfree(char *s);
+extern _mxml_types_t	*_mxml_types_new(size_t num_types, const char * const *names, const mxml_type_t *types);
+extern void		_mxml_types_release(_mxml_types_t *t);
+extern _mxml_types_t	*_mxml_types_retain(_mxml_types_t *t);
 
 #endif // !MXML_PRIVATE_H
@@ -136,7 +136,7 @@ mxmlFindPath(mxml_node_t *top,		// I - Top node
   }
 
   // If we get this far, return the node or its first child...
-  if (node->child && node->child->type != MXML_TYPE_ELEMENT)
+  if (mxmlGetFirstChild(node) && node->child->type != MXML_TYPE_ELEMENT)
     return (node->child);
   else
     return (node);
@@ -160,7 +160,7 @@ mxmlWalkNext(mxml_node_t    *node,	// I - Current node
   {
     return (NULL);
   }
-  else if (node->child && descend != MXML_DESCEND_NONE)
+  else if (descend != MXML_DESCEND_NONE && mxmlGetFirstChild(node))
   {
     return (node->child);
   }
@@ -212,12 +212,12 @@ mxmlWalkPrev(mxml_node_t    *node,	// I - Current node
   }
   else if (node->prev)
   {
-    if (node->prev->last_child && descend != MXML_DESCEND_NONE)
+    if (descend != MXML_DESCEND_NONE && mxmlGetLastChild(node->prev))
     {
       // Find the last child under the previous node...
       node = node->prev->last_child;
 
-      while (node->last_child)
+      while (mxmlGetLastChild(node))
         node = node->last_child;
 
       return (node);
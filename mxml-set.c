@@ -27,7 +27,7 @@ mxmlSetCDATA(mxml_node_t *node,		// I - Node to set
 
 
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_CDATA)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_CDATA)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_CDATA)
@@ -70,7 +70,7 @@ mxmlSetCDATAf(mxml_node_t *node,	// I - Node
 
 
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_CDATA)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_CDATA)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_CDATA)
@@ -107,7 +107,7 @@ mxmlSetComment(mxml_node_t *node,	// I - Node
 
 
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_COMMENT)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_COMMENT)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_COMMENT)
@@ -146,7 +146,7 @@ mxmlSetCommentf(mxml_node_t *node,	// I - Node
 
 
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_COMMENT)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_COMMENT)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_COMMENT)
@@ -185,7 +185,7 @@ mxmlSetCustom(
     void               *free_cbdata)	// I - Free callback data
 {
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_CUSTOM)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_CUSTOM)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_CUSTOM)
@@ -224,7 +224,7 @@ mxmlSetDeclaration(
 
 
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_DECLARATION)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_DECLARATION)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_DECLARATION)
@@ -263,7 +263,7 @@ mxmlSetDeclarationf(mxml_node_t *node,	// I - Node
 
 
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_DECLARATION)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_DECLARATION)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_DECLARATION)
@@ -300,7 +300,7 @@ mxmlSetDirective(mxml_node_t *node,	// I - Node
 
 
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_DIRECTIVE)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_DIRECTIVE)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_DIRECTIVE)
@@ -340,7 +340,7 @@ mxmlSetDirectivef(mxml_node_t *node,	// I - Node
 
 
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_DIRECTIVE)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_DIRECTIVE)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_DIRECTIVE)
@@ -390,8 +390,13 @@ mxmlSetElement(mxml_node_t *node,	// I - Node to set
   if ((s = _mxml_strcopy(name)) == NULL)
     return (false);
 
-  _mxml_strfree(node->value.element.name);
+  if (node->shared_name)
+    _mxml_name_release(node->value.element.name);
+  else
+    _mxml_strfree(node->value.element.name);
+
   node->value.element.name = s;
+  node->shared_name        = false;
 
   return (true);
 }
@@ -409,7 +414,7 @@ mxmlSetInteger(mxml_node_t *node,	// I - Node to set
                long        integer)	// I - Integer value
 {
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_INTEGER)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_INTEGER)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_INTEGER)
@@ -437,7 +442,7 @@ mxmlSetOpaque(mxml_node_t *node,	// I - Node to set
 
 
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_OPAQUE)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_OPAQUE)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_OPAQUE)
@@ -477,7 +482,7 @@ mxmlSetOpaquef(mxml_node_t *node,	// I - Node to set
 
 
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_OPAQUE)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_OPAQUE)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_OPAQUE)
@@ -512,7 +517,7 @@ mxmlSetReal(mxml_node_t *node,		// I - Node to set
             double      real)		// I - Real number value
 {
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_REAL)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_REAL)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_REAL)
@@ -541,7 +546,7 @@ mxmlSetText(mxml_node_t *node,		// I - Node to set
 
 
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_TEXT)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_TEXT)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_TEXT)
@@ -587,7 +592,7 @@ mxmlSetTextf(mxml_node_t *node,		// I - Node to set
 
 
   // Range check input...
-  if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_TEXT)
+  if (node && node->type == MXML_TYPE_ELEMENT && mxmlGetFirstChild(node) && node->child->type == MXML_TYPE_TEXT)
     node = node->child;
 
   if (!node || node->type != MXML_TYPE_TEXT)
@@ -624,6 +629,10 @@ mxmlSetUserData(mxml_node_t *node,	// I - Node to set
   if (!node)
     return (false);
 
+  // Load the children of a lazily loaded element before replacing the source
+  // in the user data pointer...
+  _mxml_lazy_load(node);
+
   // Set the user data pointer and return...
   node->user_data = data;
   return (true);
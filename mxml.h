@@ -48,6 +48,13 @@ typedef enum mxml_add_e			// @link mxmlAdd@ add values
   MXML_ADD_AFTER			// Add node after specified node
 } mxml_add_t;
 
+typedef enum mxml_compression_e		// @link mxmlOptionsSetCompression@ values
+{
+  MXML_COMPRESSION_AUTO,		// Decompress gzip data automatically
+  MXML_COMPRESSION_NONE,		// Never decompress data
+  MXML_COMPRESSION_GZIP			// Always decompress gzip or zlib data
+} mxml_compression_t;
+
 typedef enum mxml_descend_e		// @link mxmlFindElement@, @link mxmlWalkNext@, and @link mxmlWalkPrev@ descend values
 {
   MXML_DESCEND_FIRST = -1,		// Descend for first find
@@ -63,7 +70,8 @@ typedef enum mxml_sax_event_e		// SAX event type.
   MXML_SAX_EVENT_DECLARATION,		// Declaration node
   MXML_SAX_EVENT_DIRECTIVE,		// Processing instruction node
   MXML_SAX_EVENT_ELEMENT_CLOSE,		// Element closed
-  MXML_SAX_EVENT_ELEMENT_OPEN		// Element opened
+  MXML_SAX_EVENT_ELEMENT_OPEN,		// Element opened
+  MXML_SAX_EVENT_NONE			// No current event (pull parser only)
 } mxml_sax_event_t;
 
 typedef enum mxml_type_e		// The XML node type.
@@ -100,6 +108,18 @@ typedef struct _mxml_index_s mxml_index_t;
 typedef struct _mxml_options_s mxml_options_t;
 					// XML options
 
+typedef struct _mxml_parser_s mxml_parser_t;
+					// Push parser
+
+typedef struct _mxml_reader_s mxml_reader_t;
+					// Pull parser
+
+typedef struct _mxml_stream_s mxml_stream_t;
+					// Document stream
+
+typedef struct _mxml_attrs_s mxml_attrs_t;
+					// Element attributes for the event callback
+
 typedef void (*mxml_custfree_cb_t)(void *cbdata, void *custdata);
 					// Custom data destructor
 
@@ -112,6 +132,9 @@ typedef char *(*mxml_custsave_cb_t)(void *cbdata, mxml_node_t *node);
 typedef int (*mxml_entity_cb_t)(void *cbdata, const char *name);
 					// Entity callback function
 
+typedef bool (*mxml_event_cb_t)(void *cbdata, mxml_sax_event_t event, const char *data, size_t datalen, mxml_attrs_t *attrs);
+					// Event callback function
+
 typedef size_t (*mxml_io_cb_t)(void *cbdata, void *buffer, size_t bytes);
 					// Read/write callback function
 
@@ -137,6 +160,8 @@ typedef const char *(*mxml_ws_cb_t)(void *cbdata, mxml_node_t *node, mxml_ws_t w
 
 extern void		mxmlAdd(mxml_node_t *parent, mxml_add_t add, mxml_node_t *child, mxml_node_t *node);
 
+extern bool		mxmlAttrsNext(mxml_attrs_t *attrs, const char **name, size_t *namelen, const char **value, size_t *valuelen);
+
 extern void		mxmlDelete(mxml_node_t *node);
 
 extern void		mxmlElementClearAttr(mxml_node_t *node, const char *name);
@@ -175,19 +200,29 @@ extern size_t		mxmlIndexGetCount(mxml_index_t *ind);
 extern mxml_index_t	*mxmlIndexNew(mxml_node_t *node, const char *element, const char *attr);
 extern mxml_node_t	*mxmlIndexReset(mxml_index_t *ind);
 
+extern mxml_node_t	*mxmlLoadBuffer(mxml_node_t *top, mxml_options_t *options, const void *data, size_t datalen);
 extern mxml_node_t	*mxmlLoadFd(mxml_node_t *top, mxml_options_t *options, int fd);
 extern mxml_node_t	*mxmlLoadFile(mxml_node_t *top, mxml_options_t *options, FILE *fp);
 extern mxml_node_t	*mxmlLoadFilename(mxml_node_t *top, mxml_options_t *options, const char *filename);
+extern size_t		mxmlLoadFilenames(const char * const *filenames, size_t count, mxml_options_t *options, size_t nthreads, mxml_node_t **results);
 extern mxml_node_t	*mxmlLoadIO(mxml_node_t *top, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata);
+extern mxml_node_t	*mxmlLoadNext(mxml_stream_t *stream);
 extern mxml_node_t	*mxmlLoadString(mxml_node_t *top, mxml_options_t *options, const char *s);
 
 extern void		mxmlOptionsDelete(mxml_options_t *options);
 extern mxml_options_t	*mxmlOptionsNew(void);
+extern void		mxmlOptionsSetCompression(mxml_options_t *options, mxml_compression_t compression);
 extern void		mxmlOptionsSetCustomCallbacks(mxml_options_t *options, mxml_custload_cb_t load_cb, mxml_custsave_cb_t save_cb, void *cbdata);
 extern void		mxmlOptionsSetEntityCallback(mxml_options_t *options, mxml_entity_cb_t cb, void *cbdata);
 extern void		mxmlOptionsSetErrorCallback(mxml_options_t *options, mxml_error_cb_t cb, void *cbdata);
+extern void		mxmlOptionsSetEventCallback(mxml_options_t *options, mxml_event_cb_t cb, void *cbdata);
+extern bool		mxmlOptionsSetFilter(mxml_options_t *options, size_t num_paths, const char * const *paths);
+extern void		mxmlOptionsSetLazy(mxml_options_t *options, bool lazy);
+extern void		mxmlOptionsSetReadAhead(mxml_options_t *options, bool readahead);
 extern void		mxmlOptionsSetSAXCallback(mxml_options_t *options, mxml_sax_cb_t cb, void *cbdata);
+extern void		mxmlOptionsSetThreads(mxml_options_t *options, size_t nthreads);
 extern void		mxmlOptionsSetTypeCallback(mxml_options_t *options, mxml_type_cb_t cb, void *cbdata);
+extern bool		mxmlOptionsSetTypeTable(mxml_options_t *options, size_t num_types, const char * const *names, const mxml_type_t *types);
 extern void		mxmlOptionsSetTypeValue(mxml_options_t *options, mxml_type_t type);
 extern void		mxmlOptionsSetWhitespaceCallback(mxml_options_t *options, mxml_ws_cb_t cb, void *cbdata);
 extern void		mxmlOptionsSetWrapMargin(mxml_options_t *options, int column);
@@ -210,6 +245,21 @@ extern mxml_node_t	*mxmlNewText(mxml_node_t *parent, bool whitespace, const char
 extern mxml_node_t	*mxmlNewTextf(mxml_node_t *parent, bool whitespace, const char *format, ...) MXML_FORMAT(3,4);
 extern mxml_node_t	*mxmlNewXML(const char *version);
 
+extern void		mxmlParserDelete(mxml_parser_t *parser);
+extern bool		mxmlParserFeed(mxml_parser_t *parser, const void *data, size_t datalen);
+extern mxml_node_t	*mxmlParserFinish(mxml_parser_t *parser);
+extern mxml_parser_t	*mxmlParserNew(mxml_node_t *top, mxml_options_t *options);
+
+extern void		mxmlReaderDelete(mxml_reader_t *reader);
+extern mxml_attrs_t	*mxmlReaderGetAttrs(mxml_reader_t *reader);
+extern const char	*mxmlReaderGetData(mxml_reader_t *reader, size_t *datalen);
+extern mxml_sax_event_t	mxmlReaderGetEvent(mxml_reader_t *reader);
+extern mxml_reader_t	*mxmlReaderNewBuffer(mxml_options_t *options, const void *data, size_t datalen);
+extern mxml_reader_t	*mxmlReaderNewFd(mxml_options_t *options, int fd);
+extern mxml_reader_t	*mxmlReaderNewFile(mxml_options_t *options, FILE *fp);
+extern mxml_reader_t	*mxmlReaderNewIO(mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata);
+extern bool		mxmlReaderNext(mxml_reader_t *reader);
+
 extern int		mxmlRelease(mxml_node_t *node);
 extern void		mxmlRemove(mxml_node_t *node);
 extern int		mxmlRetain(mxml_node_t *node);
@@ -240,6 +290,20 @@ extern bool		mxmlSetText(mxml_node_t *node, bool whitespace, const char *string)
 extern bool		mxmlSetTextf(mxml_node_t *node, bool whitespace, const char *format, ...) MXML_FORMAT(3,4);
 extern bool		mxmlSetUserData(mxml_node_t *node, void *data);
 
+extern bool		mxmlSkipChildren(mxml_node_t *node);
+
+extern void		mxmlStreamDelete(mxml_stream_t *stream);
+extern mxml_stream_t	*mxmlStreamNewBuffer(mxml_options_t *options, const void *data, size_t datalen);
+extern mxml_stream_t	*mxmlStreamNewFd(mxml_options_t *options, int fd);
+extern mxml_stream_t	*mxmlStreamNewFile(mxml_options_t *options, FILE *fp);
+extern mxml_stream_t	*mxmlStreamNewIO(mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata);
+
+extern bool		mxmlValidateBuffer(mxml_options_t *options, const void *data, size_t datalen, int *errline, size_t *erroffset);
+extern bool		mxmlValidateFd(mxml_options_t *options, int fd, int *errline, size_t *erroffset);
+extern bool		mxmlValidateFile(mxml_options_t *options, FILE *fp, int *errline, size_t *erroffset);
+extern bool		mxmlValidateIO(mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, int *errline, size_t *erroffset);
+extern bool		mxmlValidateString(mxml_options_t *options, const char *s, int *errline, size_t *erroffset);
+
 extern mxml_node_t	*mxmlWalkNext(mxml_node_t *node, mxml_node_t *top, mxml_descend_t descend);
 extern mxml_node_t	*mxmlWalkPrev(mxml_node_t *node, mxml_node_t *top, mxml_descend_t descend);
 
@@ -19,6 +19,9 @@
 #ifndef O_BINARY
 #  define O_BINARY 0
 #endif // !O_BINARY
+#ifdef HAVE_ZLIB_H
+#  include <zlib.h>
+#endif // HAVE_ZLIB_H
 
 
 //
@@ -32,6 +35,8 @@ int		event_counts[7];
 // Local functions...
 //
 
+void		error_cb(void *cbdata, const char *message);
+bool		event_cb(void *cbdata, mxml_sax_event_t event, const char *data, size_t datalen, mxml_attrs_t *attrs);
 bool		sax_cb(void *cbdata, mxml_node_t *node, mxml_sax_event_t event);
 mxml_type_t	type_cb(void *cbdata, mxml_node_t *node);
 const char	*whitespace_cb(void *cbdata, mxml_node_t *node, mxml_ws_t where);
@@ -48,12 +53,51 @@ main(int  argc,				// I - Number of command-line args
   int			i;		// Looping var
   FILE			*fp;		// File to read
   int			fd;		// File descriptor
+#if !_WIN32
+  int			fds[2];		// Pipe
+#endif // !_WIN32
   mxml_options_t	*options;	// Load/save options
   mxml_node_t		*xml,		// <?xml ...?> node
 			*tree,		// Element tree
 			*node;		// Node which should be in test.xml
   mxml_index_t		*ind;		// XML index
-  char			buffer[16384];	// Save string
+  mxml_parser_t		*parser;	// Push parser
+  mxml_reader_t		*reader;	// Pull parser
+  mxml_stream_t		*stream;	// Document stream
+  const char		*filenames[8];	// Files to load
+  mxml_node_t		*results[8];	// Loaded files
+  const char		*filters[1];	// Paths to load
+  static const char	*typenames[] =	// Element names with value types
+			{
+			  "count",
+			  "price"
+			};
+  static const mxml_type_t typevalues[] =
+			{		// Value types for element names
+			  MXML_TYPE_INTEGER,
+			  MXML_TYPE_REAL
+			};
+  static const long	intvalues[] =	// Expected integer values
+			{
+			  -42,
+			  31,
+			  15
+			};
+  static const double	realvalues[] =	// Expected real values
+			{
+			  0.1,
+			  -2.5e3,
+			  1.2345678901234567e-40,
+			  4.9e-324,
+			  123456789012345678901234567890.0
+			};
+#ifdef HAVE_ZLIB_H
+  z_stream		zstream;	// Compression stream
+#endif // HAVE_ZLIB_H
+  char			buffer[16384],	// Save string
+			*large,		// Large document
+			*saved;		// Saved large document
+  size_t		length;		// Length of large document
   const char		*text;		// Text string
   bool			whitespace;	// Whitespace before text string
   static const char	*types[] =	// Strings for node types
@@ -431,6 +475,544 @@ main(int  argc,				// I - Number of command-line args
 
   mxmlDelete(xml);
 
+  // Test loading from a buffer that is not nul-terminated...
+  xml = mxmlLoadBuffer(/*top*/NULL, options, "<?xml version=\"1.0\"?><buffer>value</buffer><trailing>", 43);
+
+  if ((node = mxmlFindPath(xml, "buffer")) == NULL)
+  {
+    fputs("ERROR: Unable to find value for \"buffer\" in mxmlLoadBuffer test.\n", stderr);
+    mxmlDelete(xml);
+    return (1);
+  }
+  else if (mxmlGetType(node) != MXML_TYPE_OPAQUE || strcmp(mxmlGetOpaque(node), "value"))
+  {
+    fputs("ERROR: Bad value for \"buffer\" in mxmlLoadBuffer test.\n", stderr);
+    mxmlDelete(xml);
+    return (1);
+  }
+
+  mxmlDelete(xml);
+
+  // Test loading an element with many attributes...
+  snprintf(buffer, sizeof(buffer), "<wide");
+  for (i = 0; i < 200; i ++)
+    snprintf(buffer + strlen(buffer), sizeof(buffer) - strlen(buffer), " a%d=\"%d\"", i, i);
+  snprintf(buffer + strlen(buffer), sizeof(buffer) - strlen(buffer), "/>");
+
+  xml = mxmlLoadString(/*top*/NULL, options, buffer);
+
+  if (mxmlElementGetAttrCount(xml) != 200 || (text = mxmlElementGetAttr(xml, "a150")) == NULL || strcmp(text, "150"))
+  {
+    fputs("ERROR: Bad attributes for \"wide\" element.\n", stderr);
+    mxmlDelete(xml);
+    return (1);
+  }
+
+  mxmlDelete(xml);
+
+  // Test renaming one of several loaded elements with the same name...
+  xml = mxmlLoadString(/*top*/NULL, options, "<names><same/><same/></names>");
+
+  if ((node = mxmlGetFirstChild(xml)) == NULL || !mxmlSetElement(node, "renamed") || strcmp(mxmlGetElement(node), "renamed") || (node = mxmlGetNextSibling(node)) == NULL || strcmp(mxmlGetElement(node), "same"))
+  {
+    fputs("ERROR: Bad element names after mxmlSetElement.\n", stderr);
+    mxmlDelete(xml);
+    return (1);
+  }
+
+  mxmlDelete(xml);
+
+  // Test loading a large document using multiple threads...
+  if ((large = malloc(4 * 1048576)) == NULL)
+  {
+    fputs("ERROR: Unable to allocate large document.\n", stderr);
+    return (1);
+  }
+
+  length = (size_t)snprintf(large, 4 * 1048576, "<?xml version=\"1.0\"?>\n<records count=\"40000\">\n");
+  for (i = 0; i < 40000; i ++)
+    length += (size_t)snprintf(large + length, 4 * 1048576 - length, "  <record id=\"%d\"><name>Record %d</name><!-- <record> --><value>%d</value></record>\n", i, i, i * 7);
+  length += (size_t)snprintf(large + length, 4 * 1048576 - length, "</records>\n");
+
+  mxmlOptionsSetThreads(options, 4);
+  xml = mxmlLoadBuffer(/*top*/NULL, options, large, length);
+  mxmlOptionsSetThreads(options, 1);
+  tree = mxmlLoadBuffer(/*top*/NULL, options, large, length);
+
+  free(large);
+
+  for (i = 0, node = mxmlGetFirstChild(mxmlFindElement(xml, xml, "records", NULL, NULL, MXML_DESCEND_ALL)); node; node = mxmlGetNextSibling(node))
+    i ++;
+
+  if (!xml || !tree || i != 80001)
+  {
+    fputs("ERROR: Unable to load large document using multiple threads.\n", stderr);
+    mxmlDelete(xml);
+    mxmlDelete(tree);
+    return (1);
+  }
+
+  large = mxmlSaveAllocString(xml, /*options*/NULL);
+  saved = mxmlSaveAllocString(tree, /*options*/NULL);
+
+  mxmlDelete(xml);
+  mxmlDelete(tree);
+
+  if (!large || !saved || strcmp(large, saved))
+  {
+    fputs("ERROR: Large document loaded using multiple threads does not match.\n", stderr);
+    free(large);
+    free(saved);
+    return (1);
+  }
+
+  free(large);
+  free(saved);
+
+  // Test loading element contents when first accessed...
+  text = "<?xml version=\"1.0\"?>\n<lazy>\n  <group name=\"a>b\"><!-- </group> --><item>one</item>\n"
+         "    <item><![CDATA[<two>]]></item><empty/></group>\n  <group><?pi </group>?><item>three</item></group>\n</lazy>\n";
+
+  mxmlOptionsSetLazy(options, true);
+  xml = mxmlLoadString(/*top*/NULL, options, text);
+  mxmlOptionsSetLazy(options, false);
+  tree = mxmlLoadString(/*top*/NULL, options, text);
+
+  if (!xml || !tree || (node = mxmlFindPath(xml, "lazy/*/item")) == NULL || strcmp(mxmlGetOpaque(node), "one"))
+  {
+    fputs("ERROR: Unable to load element contents when first accessed.\n", stderr);
+    mxmlDelete(xml);
+    mxmlDelete(tree);
+    return (1);
+  }
+
+  large = mxmlSaveAllocString(xml, /*options*/NULL);
+  saved = mxmlSaveAllocString(tree, /*options*/NULL);
+
+  mxmlDelete(xml);
+  mxmlDelete(tree);
+
+  if (!large || !saved || strcmp(large, saved))
+  {
+    fputs("ERROR: Document loaded when first accessed does not match.\n", stderr);
+    free(large);
+    free(saved);
+    return (1);
+  }
+
+  free(large);
+  free(saved);
+
+  // Test loading only the elements matching a list of paths...
+  filters[0] = "lazy/group/item";
+
+  mxmlOptionsSetFilter(options, 1, filters);
+  xml = mxmlLoadString(/*top*/NULL, options, text);
+  mxmlOptionsSetFilter(options, 0, NULL);
+
+  saved = xml ? mxmlSaveAllocString(xml, /*options*/NULL) : NULL;
+  mxmlDelete(xml);
+
+  if (!saved || strcmp(saved, "<?xml version=\"1.0\"?>\n<lazy><group name=\"a&gt;b\"><item>one</item><item><![CDATA[<two>]]></item></group><group><item>three</item></group></lazy>"))
+  {
+    fprintf(stderr, "ERROR: Filtered document does not match (got \"%s\").\n", saved ? saved : "(null)");
+    free(saved);
+    return (1);
+  }
+
+  free(saved);
+
+  // Test checking documents without loading them...
+  buffer[0] = '\0';
+  mxmlOptionsSetErrorCallback(options, error_cb, buffer);
+
+  if (!mxmlValidateString(options, text, &i, &length))
+  {
+    fprintf(stderr, "ERROR: Well-formed document failed validation on line %d: %s\n", i, buffer);
+    return (1);
+  }
+
+  if (mxmlValidateString(options, "<a>\n<b c=\"1\" c=\"2\"/></a>", &i, &length) || i != 2 || length != 20 || strncmp(buffer, "Duplicate attribute 'c'", 23))
+  {
+    fprintf(stderr, "ERROR: Duplicate attribute reported on line %d at offset %u: %s\n", i, (unsigned)length, buffer);
+    return (1);
+  }
+
+  if (mxmlValidateString(options, "<a/>\n\xff<<<garbage &&& </x>", &i, &length) || i != 2 || length != 5 || strncmp(buffer, "Invalid UTF-8 sequence.", 23))
+  {
+    fprintf(stderr, "ERROR: Invalid UTF-8 after root element reported on line %d at offset %u: %s\n", i, (unsigned)length, buffer);
+    return (1);
+  }
+
+  if (mxmlValidateString(options, "<a>\xff</a>", &i, &length) || i != 1 || length != 3 || strncmp(buffer, "Invalid UTF-8 sequence.", 23))
+  {
+    fprintf(stderr, "ERROR: Invalid UTF-8 in root element reported on line %d at offset %u: %s\n", i, (unsigned)length, buffer);
+    return (1);
+  }
+
+  if (!mxmlValidateString(options, "<a/><!-- c -->", &i, &length) || !mxmlValidateString(options, "<a/><?pi x?>\n", &i, &length))
+  {
+    fprintf(stderr, "ERROR: Comment or processing instruction after root element failed validation: %s\n", buffer);
+    return (1);
+  }
+
+  if (mxmlValidateString(options, "<?xml version=\"1.0\"?><a/><b/>", &i, &length) || strncmp(buffer, "<b> cannot be a second root element", 35))
+  {
+    fprintf(stderr, "ERROR: Second root element after XML declaration reported as: %s\n", buffer);
+    return (1);
+  }
+
+  if (mxmlValidateString(options, "<a/>\ntext", &i, &length) || i != 2 || strncmp(buffer, "Text outside the root element", 29))
+  {
+    fprintf(stderr, "ERROR: Text after root element reported on line %d: %s\n", i, buffer);
+    return (1);
+  }
+
+  mxmlOptionsSetErrorCallback(options, /*cb*/NULL, /*cbdata*/NULL);
+
+  // Test loading values using a table of types for element names, with the
+  // constant type used for other elements...
+  if (!mxmlOptionsSetTypeTable(options, 2, typenames, typevalues))
+  {
+    fputs("ERROR: Unable to set type table.\n", stderr);
+    return (1);
+  }
+
+  xml = mxmlLoadString(/*top*/NULL, options, "<?xml version=\"1.0\"?><item><count>42</count><price>1.5</price><name>two words</name></item>");
+
+  if (mxmlGetType(node = mxmlFindPath(xml, "item/count")) != MXML_TYPE_INTEGER || mxmlGetInteger(node) != 42 || mxmlGetType(node = mxmlFindPath(xml, "item/price")) != MXML_TYPE_REAL || mxmlGetReal(node) != 1.5 || mxmlGetType(node = mxmlFindPath(xml, "item/name")) != MXML_TYPE_OPAQUE)
+  {
+    fputs("ERROR: Type table did not set the value types.\n", stderr);
+    mxmlDelete(xml);
+    return (1);
+  }
+
+  mxmlDelete(xml);
+
+  // Test loading numbers that use each of the conversion methods...
+  xml = mxmlLoadString(/*top*/NULL, options, "<?xml version=\"1.0\"?><item><count>-42 0x1F 017</count><price>0.1 -2.5e3 1.2345678901234567e-40 4.9e-324 123456789012345678901234567890</price></item>");
+  mxmlOptionsSetTypeTable(options, 0, NULL, NULL);
+
+  for (i = 0, node = mxmlFindPath(xml, "item/count"); node && i < (int)(sizeof(intvalues) / sizeof(intvalues[0])); i ++, node = mxmlGetNextSibling(node))
+  {
+    if (mxmlGetInteger(node) != intvalues[i])
+    {
+      fprintf(stderr, "ERROR: Integer value %d is %ld, expected %ld.\n", i + 1, mxmlGetInteger(node), intvalues[i]);
+      mxmlDelete(xml);
+      return (1);
+    }
+  }
+
+  if (i != (int)(sizeof(intvalues) / sizeof(intvalues[0])))
+  {
+    fprintf(stderr, "ERROR: Loaded %d integer values, expected %d.\n", i, (int)(sizeof(intvalues) / sizeof(intvalues[0])));
+    mxmlDelete(xml);
+    return (1);
+  }
+
+  for (i = 0, node = mxmlFindPath(xml, "item/price"); node && i < (int)(sizeof(realvalues) / sizeof(realvalues[0])); i ++, node = mxmlGetNextSibling(node))
+  {
+    if (mxmlGetReal(node) != realvalues[i])
+    {
+      fprintf(stderr, "ERROR: Real value %d is %.17g, expected %.17g.\n", i + 1, mxmlGetReal(node), realvalues[i]);
+      mxmlDelete(xml);
+      return (1);
+    }
+  }
+
+  if (i != (int)(sizeof(realvalues) / sizeof(realvalues[0])))
+  {
+    fprintf(stderr, "ERROR: Loaded %d real values, expected %d.\n", i, (int)(sizeof(realvalues) / sizeof(realvalues[0])));
+    mxmlDelete(xml);
+    return (1);
+  }
+
+  mxmlDelete(xml);
+
+  // Test loading UTF-16 data, which is converted to UTF-8...
+  buffer[0] = (char)0xff;
+  buffer[1] = (char)0xfe;
+
+  for (i = 2, text = "<utf16>0123456789abcdef0123456789abcdef\351</utf16>"; *text; text ++, i += 2)
+  {
+    buffer[i]     = *text;
+    buffer[i + 1] = 0;
+  }
+
+  xml = mxmlLoadBuffer(/*top*/NULL, options, buffer, (size_t)i);
+
+  if (!xml || !mxmlGetOpaque(xml) || strcmp(mxmlGetOpaque(xml), "0123456789abcdef0123456789abcdef\303\251"))
+  {
+    fputs("ERROR: Bad value for \"utf16\" in UTF-16 test.\n", stderr);
+    mxmlDelete(xml);
+    return (1);
+  }
+
+  mxmlDelete(xml);
+
+  // Test loading data a few bytes at a time with a push parser...
+  if ((parser = mxmlParserNew(/*top*/NULL, options)) == NULL)
+  {
+    fputs("ERROR: Unable to create push parser.\n", stderr);
+    return (1);
+  }
+
+  for (text = "<?xml version=\"1.0\"?><push a=\"&lt;b&gt;\"><!-- c --><value>d &amp; e \303\251</value></push>"; *text; text += i)
+  {
+    if ((i = (int)strlen(text)) > 3)
+      i = 3;
+
+    if (!mxmlParserFeed(parser, text, (size_t)i))
+    {
+      fputs("ERROR: Unable to push data to push parser.\n", stderr);
+      mxmlParserDelete(parser);
+      return (1);
+    }
+  }
+
+  xml = mxmlParserFinish(parser);
+
+  mxmlParserDelete(parser);
+
+  if ((node = mxmlFindPath(xml, "push/value")) == NULL)
+  {
+    fputs("ERROR: Unable to find value for \"push/value\" in push parser test.\n", stderr);
+    mxmlDelete(xml);
+    return (1);
+  }
+  else if (mxmlGetType(node) != MXML_TYPE_OPAQUE || strcmp(mxmlGetOpaque(node), "d & e \303\251"))
+  {
+    fputs("ERROR: Bad value for \"push/value\" in push parser test.\n", stderr);
+    mxmlDelete(xml);
+    return (1);
+  }
+  else if ((text = mxmlElementGetAttr(mxmlFindElement(xml, xml, "push", NULL, NULL, MXML_DESCEND_ALL), "a")) == NULL || strcmp(text, "<b>"))
+  {
+    fputs("ERROR: Bad attribute for \"push\" in push parser test.\n", stderr);
+    mxmlDelete(xml);
+    return (1);
+  }
+
+  mxmlDelete(xml);
+
+  // Test loading a large comment a few bytes at a time with a push parser...
+  memcpy(buffer, "<big><!--", 9);
+  for (i = 9; i < (int)sizeof(buffer) - 16; i ++)
+    buffer[i] = (i & 63) ? ((i & 63) == 32 ? '\n' : 'c') : '>';
+  memcpy(buffer + i, "--></big>", 10);
+
+  if ((parser = mxmlParserNew(/*top*/NULL, options)) == NULL)
+  {
+    fputs("ERROR: Unable to create push parser.\n", stderr);
+    return (1);
+  }
+
+  for (text = buffer; *text; text += i)
+  {
+    if ((i = (int)strlen(text)) > 3)
+      i = 3;
+
+    if (!mxmlParserFeed(parser, text, (size_t)i))
+    {
+      fputs("ERROR: Unable to push large comment to push parser.\n", stderr);
+      mxmlParserDelete(parser);
+      return (1);
+    }
+  }
+
+  xml = mxmlParserFinish(parser);
+
+  mxmlParserDelete(parser);
+
+  if ((text = mxmlGetComment(mxmlGetFirstChild(xml))) == NULL || strlen(text) != (sizeof(buffer) - 16 - 9) || strncmp(text, buffer + 9, strlen(text)))
+  {
+    fputs("ERROR: Bad large comment in push parser test.\n", stderr);
+    mxmlDelete(xml);
+    return (1);
+  }
+
+  mxmlDelete(xml);
+
+  // Test loading a stream of documents...
+  text = "<?xml version=\"1.0\"?><doc>1</doc>\n<doc>2</doc><doc/>\n";
+
+  if ((stream = mxmlStreamNewBuffer(options, text, strlen(text))) == NULL)
+  {
+    fputs("ERROR: Unable to create document stream.\n", stderr);
+    return (1);
+  }
+
+  for (i = 0; (xml = mxmlLoadNext(stream)) != NULL; i ++)
+  {
+    if (mxmlGetType(xml) == MXML_TYPE_ELEMENT)
+      node = xml;
+    else
+      node = mxmlFindElement(xml, xml, "doc", NULL, NULL, MXML_DESCEND_ALL);
+
+    if (!node || strcmp(mxmlGetElement(node), "doc") || (i < 2 && (!mxmlGetOpaque(node) || atoi(mxmlGetOpaque(node)) != i + 1)))
+    {
+      fprintf(stderr, "ERROR: Bad document #%d in document stream.\n", i + 1);
+      mxmlDelete(xml);
+      mxmlStreamDelete(stream);
+      return (1);
+    }
+
+    mxmlDelete(xml);
+  }
+
+  mxmlStreamDelete(stream);
+
+  if (i != 3)
+  {
+    fprintf(stderr, "ERROR: Loaded %d documents from document stream, expected 3.\n", i);
+    return (1);
+  }
+
+#ifdef HAVE_ZLIB_H
+  // Test loading gzip-compressed data that is larger than the read buffer...
+  memset(&zstream, 0, sizeof(zstream));
+  deflateInit2(&zstream, Z_BEST_COMPRESSION, Z_DEFLATED, 31, 8, Z_DEFAULT_STRATEGY);
+
+  zstream.next_out  = (Bytef *)buffer;
+  zstream.avail_out = sizeof(buffer);
+
+  for (i = 0; i < 10002; i ++)
+  {
+    if (i == 0)
+      text = "<?xml version=\"1.0\"?><gzip>";
+    else if (i == 10001)
+      text = "</gzip>";
+    else
+      text = "<value>0123456789</value>";
+
+    zstream.next_in  = (Bytef *)text;
+    zstream.avail_in = (uInt)strlen(text);
+
+    deflate(&zstream, i == 10001 ? Z_FINISH : Z_NO_FLUSH);
+  }
+
+  xml = mxmlLoadBuffer(/*top*/NULL, options, buffer, sizeof(buffer) - zstream.avail_out);
+
+  deflateEnd(&zstream);
+
+  for (i = 0, node = mxmlFindElement(xml, xml, "value", NULL, NULL, MXML_DESCEND_ALL); node; node = mxmlFindElement(node, xml, "value", NULL, NULL, MXML_DESCEND_ALL))
+    i ++;
+
+  if (i != 10000)
+  {
+    fprintf(stderr, "ERROR: Found %d values in gzip test, expected 10000.\n", i);
+    mxmlDelete(xml);
+    return (1);
+  }
+
+  mxmlDelete(xml);
+#endif // HAVE_ZLIB_H
+
+  // Test loading multiple files with worker threads...
+  if (argv[1][0] != '<')
+  {
+    for (i = 0; i < 8; i ++)
+      filenames[i] = argv[1];
+
+    if (mxmlLoadFilenames(filenames, 8, options, 4, results) != 8)
+    {
+      fputs("ERROR: Unable to load files with mxmlLoadFilenames.\n", stderr);
+      return (1);
+    }
+
+    for (i = 0; i < 8; i ++)
+      mxmlDelete(results[i]);
+
+    // Test loading a file with a read-ahead thread...
+    mxmlOptionsSetReadAhead(options, true);
+    xml = mxmlLoadFilename(/*top*/NULL, options, argv[1]);
+    mxmlOptionsSetReadAhead(options, false);
+
+    if (!xml)
+    {
+      fputs("ERROR: Unable to load file with read-ahead thread.\n", stderr);
+      return (1);
+    }
+
+    mxmlDelete(xml);
+  }
+
+  // Test that loading leaves a file that can seek just after the last
+  // character that was parsed...
+  if ((fp = tmpfile()) != NULL)
+  {
+    fputs("<?xml version=\"1.0\"?><a></b>more data", fp);
+    rewind(fp);
+
+    mxmlOptionsSetErrorCallback(options, error_cb, buffer);
+    xml = mxmlLoadFile(/*top*/NULL, options, fp);
+    mxmlOptionsSetErrorCallback(options, /*cb*/NULL, /*cbdata*/NULL);
+
+    if (xml)
+    {
+      fputs("ERROR: Loaded bad XML from a temporary file.\n", stderr);
+      mxmlDelete(xml);
+      fclose(fp);
+      return (1);
+    }
+
+    if (!fgets(buffer, sizeof(buffer), fp) || strcmp(buffer, "more data"))
+    {
+      fprintf(stderr, "ERROR: File position after load is wrong (read \"%s\").\n", buffer);
+      fclose(fp);
+      return (1);
+    }
+
+    fclose(fp);
+  }
+
+#if !_WIN32
+  // Test that an error with a read-ahead thread doesn't wait for a pipe that
+  // is still open...
+  if (!pipe(fds))
+  {
+    text = "<?xml version=\"1.0\"?><a><b></c>";
+
+    if (write(fds[1], text, strlen(text)) < 0)
+      perror("write");
+
+    mxmlOptionsSetReadAhead(options, true);
+    mxmlOptionsSetErrorCallback(options, error_cb, buffer);
+    xml = mxmlLoadFd(/*top*/NULL, options, fds[0]);
+    mxmlOptionsSetErrorCallback(options, /*cb*/NULL, /*cbdata*/NULL);
+    mxmlOptionsSetReadAhead(options, false);
+
+    if (xml)
+    {
+      fputs("ERROR: Loaded bad XML from a pipe with read-ahead thread.\n", stderr);
+      mxmlDelete(xml);
+      close(fds[0]);
+      close(fds[1]);
+      return (1);
+    }
+
+    // The read-ahead thread must have stopped, so data written now is left
+    // for the next reader of the pipe...
+    text = "<more/>";
+
+    if (write(fds[1], text, strlen(text)) < 0)
+      perror("write");
+
+    close(fds[1]);
+
+    memset(buffer, 0, 16);
+    length = (size_t)read(fds[0], buffer, 15);
+
+    close(fds[0]);
+
+    if (length != strlen(text) || strcmp(buffer, text))
+    {
+      fprintf(stderr, "ERROR: Read-ahead thread still reading from pipe after load (got \"%s\").\n", buffer);
+      return (1);
+    }
+  }
+#endif // !_WIN32
+
   // Open the file/string using the default callback...
   mxmlOptionsSetTypeValue(options, MXML_TYPE_TEXT);
 
@@ -610,6 +1192,127 @@ main(int  argc,				// I - Number of command-line args
       fprintf(stderr, "MXML_SAX_EVENT_ELEMENT_OPEN seen %d times, expected 20 times.\n", event_counts[MXML_SAX_EVENT_ELEMENT_OPEN]);
       return (1);
     }
+
+    // Test skipping the contents of elements via SAX...
+    memset(event_counts, 0, sizeof(event_counts));
+
+    mxmlOptionsSetSAXCallback(options, sax_cb, /*cbdata*/"choice");
+    mxmlRelease(mxmlLoadFilename(/*top*/NULL, options, argv[1]));
+
+    if (event_counts[MXML_SAX_EVENT_DATA] != 37)
+    {
+      fprintf(stderr, "MXML_SAX_EVENT_DATA seen %d times with skipped elements, expected 37 times.\n", event_counts[MXML_SAX_EVENT_DATA]);
+      return (1);
+    }
+
+    if (event_counts[MXML_SAX_EVENT_ELEMENT_CLOSE] != 11)
+    {
+      fprintf(stderr, "MXML_SAX_EVENT_ELEMENT_CLOSE seen %d times with skipped elements, expected 11 times.\n", event_counts[MXML_SAX_EVENT_ELEMENT_CLOSE]);
+      return (1);
+    }
+
+    if (event_counts[MXML_SAX_EVENT_ELEMENT_OPEN] != 11)
+    {
+      fprintf(stderr, "MXML_SAX_EVENT_ELEMENT_OPEN seen %d times with skipped elements, expected 11 times.\n", event_counts[MXML_SAX_EVENT_ELEMENT_OPEN]);
+      return (1);
+    }
+
+    // Test the event callback, which does not create nodes...
+    memset(event_counts, 0, sizeof(event_counts));
+    i = 0;
+
+    mxmlOptionsSetSAXCallback(options, /*cb*/NULL, /*cbdata*/NULL);
+    mxmlOptionsSetEventCallback(options, event_cb, &i);
+    mxmlLoadFilename(/*top*/NULL, options, argv[1]);
+    mxmlOptionsSetEventCallback(options, /*cb*/NULL, /*cbdata*/NULL);
+
+    if (event_counts[MXML_SAX_EVENT_DATA] != 41)
+    {
+      fprintf(stderr, "MXML_SAX_EVENT_DATA seen %d times with event callback, expected 41 times.\n", event_counts[MXML_SAX_EVENT_DATA]);
+      return (1);
+    }
+
+    if (event_counts[MXML_SAX_EVENT_ELEMENT_CLOSE] != 20 || event_counts[MXML_SAX_EVENT_ELEMENT_OPEN] != 20)
+    {
+      fprintf(stderr, "MXML_SAX_EVENT_ELEMENT_CLOSE/OPEN seen %d/%d times with event callback, expected 20 times.\n", event_counts[MXML_SAX_EVENT_ELEMENT_CLOSE], event_counts[MXML_SAX_EVENT_ELEMENT_OPEN]);
+      return (1);
+    }
+
+    if (i != 9)
+    {
+      fprintf(stderr, "Saw %d \"type\" attributes with event callback, expected 9.\n", i);
+      return (1);
+    }
+
+    // Test the pull parser, stopping after the first "code" element...
+    if ((fp = fopen(argv[1], "rb")) == NULL)
+    {
+      perror(argv[1]);
+      return (1);
+    }
+
+    if ((reader = mxmlReaderNewFile(options, fp)) == NULL)
+    {
+      fputs("ERROR: Unable to create pull parser.\n", stderr);
+      fclose(fp);
+      return (1);
+    }
+
+    if (mxmlReaderGetEvent(reader) != MXML_SAX_EVENT_NONE)
+    {
+      fputs("ERROR: Pull parser has an event before reading.\n", stderr);
+      mxmlReaderDelete(reader);
+      fclose(fp);
+      return (1);
+    }
+
+    for (i = 0; mxmlReaderNext(reader);)
+    {
+      if (mxmlReaderGetEvent(reader) != MXML_SAX_EVENT_ELEMENT_OPEN)
+        continue;
+
+      i ++;
+
+      if (!strcmp(mxmlReaderGetData(reader, /*datalen*/NULL), "code"))
+        break;
+    }
+
+    if (i != 10)
+    {
+      fprintf(stderr, "ERROR: Pull parser opened %d elements up to <code>, expected 10.\n", i);
+      mxmlReaderDelete(reader);
+      fclose(fp);
+      return (1);
+    }
+
+    if (!mxmlAttrsNext(mxmlReaderGetAttrs(reader), &text, /*namelen*/NULL, &text, &length) || strcmp(text, "opaque") || length != 6)
+    {
+      fputs("ERROR: Pull parser did not return type=\"opaque\" for <code>.\n", stderr);
+      mxmlReaderDelete(reader);
+      fclose(fp);
+      return (1);
+    }
+
+    if (!mxmlReaderNext(reader) || mxmlReaderGetEvent(reader) != MXML_SAX_EVENT_ELEMENT_CLOSE || mxmlReaderGetAttrs(reader))
+    {
+      fputs("ERROR: Pull parser did not close the empty <code> element.\n", stderr);
+      mxmlReaderDelete(reader);
+      fclose(fp);
+      return (1);
+    }
+
+    while (mxmlReaderNext(reader));
+
+    if (mxmlReaderGetEvent(reader) != MXML_SAX_EVENT_NONE)
+    {
+      fputs("ERROR: Pull parser has an event after the end of the document.\n", stderr);
+      mxmlReaderDelete(reader);
+      fclose(fp);
+      return (1);
+    }
+
+    mxmlReaderDelete(reader);
+    fclose(fp);
   }
 
   // Free memory used by options - not explicitly required here since we are
@@ -638,12 +1341,55 @@ main(int  argc,				// I - Number of command-line args
 }
 
 
+//
+// 'error_cb()' - Save an error message.
+//
+
+void
+error_cb(void       *cbdata,		// I - Callback data (message buffer)
+         const char *message)		// I - Error message
+{
+  snprintf((char *)cbdata, 1024, "%s", message);
+}
+
+
+//
+// 'event_cb()' - Process events without nodes.
+//
+
+bool					// O - `true` to continue, `false` to stop
+event_cb(void             *cbdata,	// I - Callback data (count of "type" attributes)
+         mxml_sax_event_t event,	// I - Event
+         const char       *data,	// I - Event data
+         size_t           datalen,	// I - Length of data
+         mxml_attrs_t     *attrs)	// I - Element attributes
+{
+  const char	*name,			// Attribute name
+		*value;			// Attribute value
+
+
+  // This callback counts the different events and "type" attributes.
+  if (strlen(data) != datalen)
+    fprintf(stderr, "ERROR: Event callback data \"%s\" has length %u.\n", data, (unsigned)datalen);
+
+  while (mxmlAttrsNext(attrs, &name, /*namelen*/NULL, &value, /*valuelen*/NULL))
+  {
+    if (!strcmp(name, "type"))
+      (*(int *)cbdata) ++;
+  }
+
+  event_counts[event] ++;
+
+  return (true);
+}
+
+
 //
 // 'sax_cb()' - Process nodes via SAX.
 //
 
 bool					// O - `true` to continue, `false` to stop
-sax_cb(void             *cbdata,	// I - SAX callback data (not used)
+sax_cb(void             *cbdata,	// I - SAX callback data (element to skip or `NULL`)
        mxml_node_t      *node,		// I - Current node
        mxml_sax_event_t event)		// I - SAX event
 {
@@ -659,11 +1405,12 @@ sax_cb(void             *cbdata,	// I - SAX callback data (not used)
   };
 
 
-  (void)cbdata;
-
-  // This SAX callback just counts the different events.
+  // This SAX callback just counts the different events, skipping the contents
+  // of the named element.
   if (!node)
     fprintf(stderr, "ERROR: SAX callback for event %s has NULL node.\n", events[event]);
+  else if (cbdata && event == MXML_SAX_EVENT_ELEMENT_OPEN && !strcmp(mxmlGetElement(node), (const char *)cbdata))
+    mxmlSkipChildren(node);
 
   event_counts[event] ++;
 
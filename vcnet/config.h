@@ -28,4 +28,18 @@
 //#  undef HAVE_PTHREAD_H
 
 
+//
+// Have <sys/mman.h>?
+//
+
+//#  undef HAVE_SYS_MMAN_H
+
+
+//
+// Have <zlib.h>?
+//
+
+//#  undef HAVE_ZLIB_H
+
+
 #endif // !MXML_CONFIG_H
@@ -27,4 +27,18 @@
 #  define HAVE_PTHREAD_H
 
 
+//
+// Have <sys/mman.h>?
+//
+
+#  define HAVE_SYS_MMAN_H
+
+
+//
+// Have <zlib.h>?
+//
+
+//#  undef HAVE_ZLIB_H
+
+
 #endif // !MXML_CONFIG_H